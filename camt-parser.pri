@@ -8,13 +8,32 @@ INCLUDEPATH += $$CAMT_ROOT
 
 # Source files of the parser
 SOURCES += \
-    $$CAMT_ROOT/gvc_map.cpp
+    $$CAMT_ROOT/gvc_map.cpp \
+    $$CAMT_ROOT/mapped_file.cpp
 
 HEADERS += \
     $$CAMT_ROOT/camt_parser_pugi.hpp \
+    $$CAMT_ROOT/camt_session.hpp \
+    $$CAMT_ROOT/camt_incremental.hpp \
+    $$CAMT_ROOT/camt_view.hpp \
+    $$CAMT_ROOT/camt_lazy.hpp \
+    $$CAMT_ROOT/camt_snapshot.hpp \
+    $$CAMT_ROOT/camt_thread_pool.hpp \
+    $$CAMT_ROOT/camt_batch.hpp \
+    $$CAMT_ROOT/camt_archive.hpp \
+    $$CAMT_ROOT/camt_pipeline.hpp \
+    $$CAMT_ROOT/camt_tags.hpp \
+    $$CAMT_ROOT/camt_currency.hpp \
+    $$CAMT_ROOT/camt_stats.hpp \
     $$CAMT_ROOT/camt_csv.hpp \
+    $$CAMT_ROOT/camt_csv_writer.hpp \
+    $$CAMT_ROOT/camt_arrow.hpp \
+    $$CAMT_ROOT/camt_fingerprint.hpp \
+    $$CAMT_ROOT/camt_dedup.hpp \
+    $$CAMT_ROOT/camt_history.hpp \
     $$CAMT_ROOT/utf_convert.hpp \
-    $$CAMT_ROOT/gvc_map.hpp
+    $$CAMT_ROOT/gvc_map.hpp \
+    $$CAMT_ROOT/mapped_file.hpp
 
 # pugixml (always needed)
 PUGI = $$CAMT_ROOT/external/pugixml/src
@@ -28,3 +47,13 @@ contains(DEFINES, USE_UTF8PROC) {
     SOURCES += $$UTF8/utf8proc.c
     HEADERS += $$UTF8/utf8proc.h
 }
+
+# zlib (optional - only if the user defines USE_ZLIB): gzip and deflated ZIP members
+contains(DEFINES, USE_ZLIB) {
+    LIBS += -lz
+}
+
+# Apache Arrow + Parquet (optional - only if the user defines USE_ARROW): camt_arrow.hpp
+contains(DEFINES, USE_ARROW) {
+    LIBS += -lparquet -larrow
+}
@@ -0,0 +1,510 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace camt {
+
+// ---------- Compressed input (gzip, ZIP) ----------
+// Banks deliver statements as ZIP containers or gzip files (EBICS). The
+// parser recognizes both by their magic bytes and decompresses them in
+// memory (Parser::parse_file / parse_mapped_file / parse_buffer) or on the
+// fly (gzip in parse_stream / parse_file(istream)); nothing is unpacked to
+// disk. BatchParser::parse_archive() parses the members of a ZIP in parallel.
+//
+// Deflate needs zlib: DEFINES += USE_ZLIB (and LIBS += -lz). Without it only
+// ZIP members that are stored uncompressed can be read; gzip input and
+// deflated members fail with an error that names USE_ZLIB.
+//
+// ZIP: a single-disk archive, ZIP64 included; encrypted members are rejected.
+// Member names are kept as stored (UTF-8 if the archiver set flag bit 11).
+enum class Compression { None, Gzip, Zip };
+
+// by magic bytes; XML cannot start with 0x1F or 'P', so one byte is enough
+// to tell a stream apart (see Parser::parse_stream())
+inline Compression detect_compression(const void* data, std::size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    if (size >= 2 && p[0] == 0x1F && p[1] == 0x8B) return Compression::Gzip;
+    if (size >= 4 && p[0] == 'P' && p[1] == 'K' && ((p[2] == 3 && p[3] == 4) || (p[2] == 5 && p[3] == 6)))
+        return Compression::Zip;  // local file header, or the end record of an empty archive
+    return Compression::None;
+}
+
+// case-insensitive suffix test, e.g. has_extension(member.name, ".xml")
+inline bool has_extension(std::string_view name, std::string_view ext)
+{
+    if (name.size() < ext.size()) return false;
+    for (std::size_t i = 0; i < ext.size(); ++i) {
+        char a = name[name.size() - ext.size() + i], b = ext[i];
+        if (a >= 'A' && a <= 'Z') a = (char)(a - 'A' + 'a');
+        if (b >= 'A' && b <= 'Z') b = (char)(b - 'A' + 'a');
+        if (a != b) return false;
+    }
+    return true;
+}
+
+namespace detail {
+inline std::uint32_t crc32(std::uint32_t crc, const void* data, std::size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+#ifdef USE_ZLIB
+    while (size) {
+        const uInt n = size > (1u << 30) ? (1u << 30) : (uInt)size;
+        crc = (std::uint32_t)::crc32(crc, p, n);
+        p += n;
+        size -= n;
+    }
+    return crc;
+#else
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+#endif
+}
+
+// little-endian fields of ZIP and gzip headers
+inline std::uint16_t rd16(const char* p)
+{
+    const unsigned char* u = (const unsigned char*)p;
+    return (std::uint16_t)(u[0] | (u[1] << 8));
+}
+inline std::uint32_t rd32(const char* p)
+{
+    return (std::uint32_t)rd16(p) | ((std::uint32_t)rd16(p + 2) << 16);
+}
+inline std::uint64_t rd64(const char* p)
+{
+    return (std::uint64_t)rd32(p) | ((std::uint64_t)rd32(p + 4) << 32);
+}
+
+inline bool archive_fail(std::string* error, const std::string& msg)
+{
+    if (error) *error = msg;
+    return false;
+}
+
+inline const char* no_zlib_message() { return "Deflate-compressed input requires USE_ZLIB"; }
+// for the classes that parse a single XML document
+inline const char* zip_unsupported_message() { return "ZIP archives are not supported, extract the member with ZipArchive::extract()"; }
+
+#ifdef USE_ZLIB
+constexpr std::size_t kInflateRatio = 16;                 // first buffer: 16x the compressed size
+constexpr std::size_t kInflateInitialMax = 64u << 20;     // ... but at most 64 MiB
+
+// windowBits: -MAX_WBITS raw deflate (ZIP), 16 + MAX_WBITS gzip. With
+// hasLimit, 'limit' is the exact output size (ZIP member, 0 included; the
+// caller keeps it within maxSize); gzip input may hold several members.
+// Output beyond 'maxSize' (0 = no cap) fails.
+inline bool inflate_buffer(const char* data, std::size_t size, int windowBits, std::size_t sizeHint,
+                           bool hasLimit, std::size_t limit, std::size_t maxSize, std::string& out, std::string* error)
+{
+    z_stream zs{};
+    if (inflateInit2(&zs, windowBits) != Z_OK) return archive_fail(error, "inflateInit failed");
+    std::unique_ptr<z_stream, int (*)(z_stream*)> guard(&zs, inflateEnd);
+
+    out.clear();
+    // one byte more than the bound: output beyond the declared size (or
+    // maxSize) shows up. Declared sizes come from the file, so they only cap
+    // the buffer; it starts at a plausible ratio of the input and doubles.
+    const bool bounded = hasLimit || maxSize;
+    const std::size_t bound = hasLimit ? limit : maxSize;
+    const std::size_t cap = std::max(bound, bound + 1); // max(): SIZE_MAX wraps
+    std::size_t first = std::min({hasLimit ? cap : (sizeHint ? sizeHint : size * 4 + 1024),
+                                  size * kInflateRatio + 4096, kInflateInitialMax});
+    if (bounded) first = std::min(first, cap);
+    out.resize(first);
+    std::size_t inPos = 0, outPos = 0;
+    for (;;) {
+        if (outPos == out.size()) {
+            if (bounded && out.size() >= cap) {
+                return archive_fail(error, hasLimit ? "Decompressed data larger than declared"
+                                                    : "Decompressed data larger than " + std::to_string(maxSize) + " bytes");
+            }
+            out.resize(bounded ? std::min(cap, out.size() * 2) : out.size() * 2);
+        }
+        const std::size_t inLeft = size - inPos, outLeft = out.size() - outPos;
+        zs.next_in = (Bytef*)(data + inPos);
+        zs.avail_in = (uInt)(inLeft > (1u << 30) ? (1u << 30) : inLeft);
+        zs.next_out = (Bytef*)(&out[0] + outPos);
+        zs.avail_out = (uInt)(outLeft > (1u << 30) ? (1u << 30) : outLeft);
+        const uInt availIn = zs.avail_in, availOut = zs.avail_out;
+        const int ret = inflate(&zs, Z_NO_FLUSH);
+        inPos += availIn - zs.avail_in;
+        outPos += availOut - zs.avail_out;
+
+        if (ret == Z_STREAM_END) {
+            // concatenated gzip members; trailing zero padding is ignored
+            if (windowBits > 0 && inPos < size && (unsigned char)data[inPos] == 0x1F) {
+                inflateReset(&zs);
+                continue;
+            }
+            break;
+        }
+        if (ret == Z_BUF_ERROR && inPos == size) return archive_fail(error, "Compressed data is truncated");
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+            return archive_fail(error, std::string("Decompression failed: ") + (zs.msg ? zs.msg : "corrupt data"));
+    }
+    if (hasLimit && outPos != limit) return archive_fail(error, "Decompressed size differs from declared");
+    if (maxSize && outPos > maxSize) return archive_fail(error, "Decompressed data larger than " + std::to_string(maxSize) + " bytes");
+    out.resize(outPos);
+    return true;
+}
+#endif
+} // namespace detail
+
+// largest output gunzip() and ZipArchive::extract() produce by default; a
+// gzip or ZIP bomb fails at this size
+constexpr std::size_t kInflateMaxSize = (std::size_t)1 << 30;
+
+// gzip (RFC 1952), all members of data are decompressed into out. Output
+// beyond maxSize (0 = no limit) is an error.
+inline bool gunzip(const char* data, std::size_t size, std::string& out, std::string* error = nullptr,
+                   std::size_t maxSize = kInflateMaxSize)
+{
+#ifdef USE_ZLIB
+    // ISIZE of the (last) member: uncompressed size mod 2^32, only a hint
+    const std::size_t hint = size >= 18 ? (std::size_t)detail::rd32(data + size - 4) : 0;
+    return detail::inflate_buffer(data, size, 16 + MAX_WBITS, hint < (1u << 30) ? hint : 0, false, 0, maxSize, out, error);
+#else
+    (void)data; (void)size; (void)maxSize; out.clear();
+    return detail::archive_fail(error, std::string("gzip input: ") + detail::no_zlib_message());
+#endif
+}
+
+#ifdef USE_ZLIB
+// Decompressing stream buffer: gzip over another stream, or raw deflate /
+// gzip over memory (a ZIP member in a mapped file). Feed it to Parser::
+// parse_stream() through a std::istream. Only the current chunks are held.
+class InflateStreamBuf : public std::streambuf {
+public:
+    enum class Format { Gzip, Raw };
+
+    explicit InflateStreamBuf(std::istream& src, Format f = Format::Gzip, std::size_t chunkSize = 64 * 1024)
+        : src_(&src), format_(f), in_(chunkSize ? chunkSize : 1), out_(chunkSize ? chunkSize : 1)
+    {
+        init();
+    }
+
+    InflateStreamBuf(const char* data, std::size_t size, Format f = Format::Raw, std::size_t chunkSize = 64 * 1024)
+        : format_(f), mem_(data), memLeft_(size), out_(chunkSize ? chunkSize : 1)
+    {
+        init();
+    }
+
+    ~InflateStreamBuf() override
+    {
+        if (ready_) inflateEnd(&zs_);
+    }
+
+    InflateStreamBuf(const InflateStreamBuf&) = delete;
+    InflateStreamBuf& operator=(const InflateStreamBuf&) = delete;
+
+    // true after a decompression error; the stream then ends early
+    bool failed() const { return !error_.empty(); }
+    const std::string& error_message() const { return error_; }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        while (ready_ && !end_) {
+            // with the input used up inflate may still hold output, so the
+            // data is only truncated if the call below makes no progress
+            const bool inputEnd = zs_.avail_in == 0 && !refill();
+            zs_.next_out = (Bytef*)out_.data();
+            zs_.avail_out = (uInt)out_.size();
+            const int ret = inflate(&zs_, Z_NO_FLUSH);
+            const std::size_t produced = out_.size() - zs_.avail_out;
+
+            if (ret == Z_STREAM_END) {
+                // another gzip member follows?
+                if (format_ == Format::Gzip && (zs_.avail_in > 0 || refill()) && *zs_.next_in == 0x1F) inflateReset(&zs_);
+                else end_ = true;
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                error_ = std::string("Decompression failed: ") + (zs_.msg ? zs_.msg : "corrupt data");
+                break;
+            }
+            if (produced) {
+                setg(out_.data(), out_.data(), out_.data() + produced);
+                return traits_type::to_int_type(*gptr());
+            }
+            if (inputEnd && !end_) {
+                error_ = "Compressed data is truncated";
+                break;
+            }
+        }
+        return traits_type::eof();
+    }
+
+private:
+    void init()
+    {
+        ready_ = inflateInit2(&zs_, format_ == Format::Gzip ? 16 + MAX_WBITS : -MAX_WBITS) == Z_OK;
+        if (!ready_) error_ = "inflateInit failed";
+    }
+
+    // false at the end of the input
+    bool refill()
+    {
+        if (src_) {
+            src_->read(in_.data(), (std::streamsize)in_.size());
+            const std::size_t n = (std::size_t)src_->gcount();
+            zs_.next_in = (Bytef*)in_.data();
+            zs_.avail_in = (uInt)n;
+            return n > 0;
+        }
+        const std::size_t n = memLeft_ > (1u << 30) ? (1u << 30) : memLeft_;
+        zs_.next_in = (Bytef*)mem_;
+        zs_.avail_in = (uInt)n;
+        mem_ += n;
+        memLeft_ -= n;
+        return n > 0;
+    }
+
+    std::istream* src_ = nullptr;
+    Format format_;
+    const char* mem_ = nullptr;
+    std::size_t memLeft_ = 0;
+    std::vector<char> in_, out_;
+    z_stream zs_{};
+    bool ready_ = false;
+    bool end_ = false;
+    std::string error_;
+};
+#endif
+
+struct ZipMember {
+    std::string name;                   // path inside the archive
+    std::uint16_t method = 0;           // 0 stored, 8 deflate
+    std::uint16_t flags = 0;
+    std::uint32_t crc = 0;
+    std::uint64_t compressedSize = 0;
+    std::uint64_t size = 0;             // uncompressed
+    std::uint64_t localHeaderOffset = 0;
+
+    bool is_directory() const { return !name.empty() && name.back() == '/'; }
+    bool encrypted() const { return (flags & 1) != 0; }
+};
+
+// Read-only ZIP archive over a mapped file or a caller's buffer. members()
+// comes from the central directory; extract() is const and may be called
+// from several threads at once.
+class ZipArchive {
+public:
+    ZipArchive() = default;
+    ZipArchive(const ZipArchive&) = delete;
+    ZipArchive& operator=(const ZipArchive&) = delete;
+
+    bool open(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        close();
+        std::string sysMsg;
+        if (!file_.open(std::filesystem::u8path(utf8Path), &sysMsg))
+            return detail::archive_fail(error, std::string("Open failed for '") + utf8Path + "': " + sysMsg);
+        return read_directory(file_.data(), file_.size(), error);
+    }
+
+    // data must stay valid while the archive is used
+    bool open_buffer(const char* data, std::size_t size, std::string* error = nullptr)
+    {
+        close();
+        return read_directory(data, size, error);
+    }
+
+    void close()
+    {
+        file_.close();
+        data_ = nullptr;
+        size_ = 0;
+        members_.clear();
+    }
+
+    const std::vector<ZipMember>& members() const { return members_; }
+    std::size_t size() const { return members_.size(); }
+
+    // decompresses member i into out and checks its CRC. A member larger
+    // than maxSize (0 = no limit) is an error.
+    bool extract(std::size_t i, std::string& out, std::string* error = nullptr,
+                 std::size_t maxSize = kInflateMaxSize) const
+    {
+        const char* raw = nullptr;
+        if (!member_data(i, raw, error)) return false;
+        const ZipMember& m = members_[i];
+        if (maxSize && m.size > maxSize)
+            return detail::archive_fail(error, "'" + m.name + "': Declared size exceeds " + std::to_string(maxSize) + " bytes");
+        if (m.method == 0) {
+            out.assign(raw, (std::size_t)m.size);
+        } else {
+#ifdef USE_ZLIB
+            std::string msg;
+            if (!detail::inflate_buffer(raw, (std::size_t)m.compressedSize, -MAX_WBITS, 0, true, (std::size_t)m.size,
+                                        maxSize, out, &msg))
+                return detail::archive_fail(error, "'" + m.name + "': " + msg);
+#else
+            return detail::archive_fail(error, "'" + m.name + "': " + detail::no_zlib_message());
+#endif
+        }
+        if (detail::crc32(0, out.data(), out.size()) != m.crc)
+            return detail::archive_fail(error, "'" + m.name + "': CRC mismatch");
+        return true;
+    }
+
+    // stream over member i, decompressed on the fly (no CRC check)
+    std::unique_ptr<std::streambuf> open_member(std::size_t i, std::string* error = nullptr) const
+    {
+        const char* raw = nullptr;
+        if (!member_data(i, raw, error)) return nullptr;
+        const ZipMember& m = members_[i];
+        if (m.method == 0) {
+            struct MemoryBuf : std::streambuf {
+                MemoryBuf(const char* p, std::size_t n) { char* b = const_cast<char*>(p); setg(b, b, b + n); }
+            };
+            return std::make_unique<MemoryBuf>(raw, (std::size_t)m.size);
+        }
+#ifdef USE_ZLIB
+        return std::make_unique<InflateStreamBuf>(raw, (std::size_t)m.compressedSize, InflateStreamBuf::Format::Raw);
+#else
+        detail::archive_fail(error, "'" + m.name + "': " + detail::no_zlib_message());
+        return nullptr;
+#endif
+    }
+
+private:
+    bool read_directory(const char* data, std::size_t size, std::string* error)
+    {
+        using detail::rd16;
+        using detail::rd32;
+        using detail::rd64;
+        auto fail = [&](const char* msg) {
+            members_.clear();
+            return detail::archive_fail(error, std::string("Invalid ZIP archive: ") + msg);
+        };
+        data_ = data;
+        size_ = size;
+
+        // end of central directory record: 22 bytes + comment (<= 64 KiB)
+        if (size < 22) return fail("too short");
+        std::size_t eocd = size - 22;
+        const std::size_t stop = size - 22 > 0xFFFF ? size - 22 - 0xFFFF : 0;
+        while (rd32(data + eocd) != 0x06054b50) {
+            if (eocd == stop) return fail("end of central directory not found");
+            --eocd;
+        }
+        std::uint64_t count = rd16(data + eocd + 10);
+        std::uint64_t cdSize = rd32(data + eocd + 12);
+        std::uint64_t cdOffset = rd32(data + eocd + 16);
+
+        if (count == 0xFFFF || cdSize == 0xFFFFFFFFu || cdOffset == 0xFFFFFFFFu) {
+            // ZIP64: locator right before the record points to the ZIP64 end record
+            if (eocd < 20 || rd32(data + eocd - 20) != 0x07064b50) return fail("ZIP64 locator missing");
+            const std::uint64_t z = rd64(data + eocd - 20 + 8);
+            if (z > size || size - z < 56 || rd32(data + z) != 0x06064b50) return fail("ZIP64 end record missing");
+            count = rd64(data + z + 32);
+            cdSize = rd64(data + z + 40);
+            cdOffset = rd64(data + z + 48);
+        }
+        if (cdOffset > size || cdSize > size - cdOffset) return fail("central directory out of range");
+        if (count > cdSize / 46) return fail("bad entry count");
+
+        members_.reserve((std::size_t)count);
+        std::size_t p = (std::size_t)cdOffset;
+        const std::size_t end = (std::size_t)(cdOffset + cdSize);
+        for (std::uint64_t k = 0; k < count; ++k) {
+            if (end - p < 46 || rd32(data + p) != 0x02014b50) return fail("bad central directory entry");
+            ZipMember m;
+            m.flags = rd16(data + p + 8);
+            m.method = rd16(data + p + 10);
+            m.crc = rd32(data + p + 16);
+            m.compressedSize = rd32(data + p + 20);
+            m.size = rd32(data + p + 24);
+            const std::size_t nameLen = rd16(data + p + 28), extraLen = rd16(data + p + 30), commentLen = rd16(data + p + 32);
+            m.localHeaderOffset = rd32(data + p + 42);
+            if (end - p - 46 < nameLen + extraLen + commentLen) return fail("bad central directory entry");
+            m.name.assign(data + p + 46, nameLen);
+
+            // ZIP64 extended information: the 32 bit fields set to 0xFFFFFFFF, in order
+            const char* x = data + p + 46 + nameLen;
+            const char* xEnd = x + extraLen;
+            while (xEnd - x >= 4) {
+                const std::uint16_t id = rd16(x), len = rd16(x + 2);
+                if ((std::size_t)(xEnd - x - 4) < len) break;
+                if (id == 0x0001) {
+                    const char* f = x + 4;
+                    const char* fEnd = f + len;
+                    auto take = [&](std::uint64_t& v) {
+                        if (v == 0xFFFFFFFFu && fEnd - f >= 8) { v = rd64(f); f += 8; }
+                    };
+                    take(m.size);
+                    take(m.compressedSize);
+                    take(m.localHeaderOffset);
+                }
+                x += 4 + len;
+            }
+            members_.push_back(std::move(m));
+            p += 46 + nameLen + extraLen + commentLen;
+        }
+        return true;
+    }
+
+    // start of member i's stored bytes, after its local header
+    bool member_data(std::size_t i, const char*& raw, std::string* error) const
+    {
+        if (i >= members_.size()) return detail::archive_fail(error, "ZIP member index out of range");
+        const ZipMember& m = members_[i];
+        if (m.encrypted()) return detail::archive_fail(error, "'" + m.name + "': encrypted ZIP members are not supported");
+        if (m.method != 0 && m.method != 8)
+            return detail::archive_fail(error, "'" + m.name + "': unsupported compression method " + std::to_string(m.method));
+        if (m.method == 0 && m.compressedSize != m.size)
+            return detail::archive_fail(error, "'" + m.name + "': bad stored size");
+
+        const std::uint64_t h = m.localHeaderOffset;
+        if (h > size_ || size_ - h < 30 || detail::rd32(data_ + h) != 0x04034b50)
+            return detail::archive_fail(error, "'" + m.name + "': bad local header");
+        const std::uint64_t start = h + 30 + detail::rd16(data_ + h + 26) + detail::rd16(data_ + h + 28);
+        if (start > size_ || size_ - start < m.compressedSize)
+            return detail::archive_fail(error, "'" + m.name + "': data out of range");
+        raw = data_ + start;
+        return true;
+    }
+
+    MappedFile file_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::vector<ZipMember> members_;
+};
+
+} // namespace camt
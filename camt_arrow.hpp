@@ -0,0 +1,335 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_csv.hpp"
+
+// ---------- Apache Arrow / Parquet export ----------
+// Typed columnar output for analytics (DuckDB, Spark, pandas), with the same
+// ExportField columns and ExportOptions as export_entries_csv(). Requires
+// Apache Arrow C++ 12 or later with Parquet; compiled in only with USE_ARROW
+// defined (DEFINES += USE_ARROW, links -larrow -lparquet).
+//
+// Column types, named as in the CSV header:
+//   BookingDate, ValueDate              int32 YYYYMMDD (canonical value)
+//   Amount, RunningBalance,             int64 minor units, in the decimals of
+//   Opening-/ClosingBalance,            the row's Currency (ChargesCurrency for
+//   ChargesAmount                       ChargesAmount); Amount signed as in the
+//                                       CSV (ExportOptions::signed_amount)
+//   IsCredit/CreditDebit, Reversal,     bool
+//   ChargesIncluded
+//   EntryOrdinal, TxOrdinal             int32
+//   codes, IBANs/BICs, currencies,      dictionary<int32, utf8>
+//   status, bank name
+//   other text                          utf8 (display value, or the canonical
+//                                       one with ArrowOptions::canonical_text)
+// Empty cells are null. Rows pass through ExportOptions::row_filter first.
+//
+//   std::shared_ptr<arrow::Table> table;
+//   if (!camt::export_entries_arrow(doc, table, opt, {}, &err)) { /* ... */ }
+//
+//   camt::ParquetWriter pq(opt);
+//   if (!pq.open("entries.parquet", &err)) { /* ... */ }
+//   for (...) pq.write(doc, &err);   // any number of documents
+//   pq.close(&err);
+
+#ifdef USE_ARROW
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace camt {
+
+struct ArrowOptions {
+    bool canonical_text = false;  // utf8 columns: .second instead of .first
+    bool dictionary = true;       // dictionary-encode the repetitive text columns
+
+    // Parquet only
+    std::int64_t rowGroupRows = 128 * 1024;
+    arrow::Compression::type compression = arrow::Compression::ZSTD; // if Arrow was built with it
+};
+
+namespace detail {
+enum class ArrowKind { Date, Minor, Bool, Int, Dict, Text };
+
+inline ArrowKind arrow_kind(ExportField f)
+{
+    using F = ExportField;
+    switch (f) {
+    case F::BookingDate:
+    case F::ValueDate:
+        return ArrowKind::Date;
+    case F::Amount:
+    case F::RunningBalance:
+    case F::OpeningBalance:
+    case F::ClosingBalance:
+    case F::ChargesAmount:
+        return ArrowKind::Minor;
+    case F::CreditDebit:
+    case F::Reversal:
+    case F::ChargesIncluded:
+        return ArrowKind::Bool;
+    case F::EntryOrdinal:
+    case F::TransactionOrdinal:
+        return ArrowKind::Int;
+    case F::Currency:
+    case F::CounterpartyBIC:
+    case F::AccountIBAN:
+    case F::AccountBIC:
+    case F::BkTxCd:
+    case F::BookingCode:
+    case F::Status:
+    case F::ServicerBankName:
+    case F::DTACode:
+    case F::GVCCode:
+    case F::SWIFTTransactionCode:
+    case F::ChargesCurrency:
+        return ArrowKind::Dict;
+    default:
+        return ArrowKind::Text;
+    }
+}
+
+inline std::shared_ptr<arrow::DataType> arrow_type(ArrowKind k, const ArrowOptions& ao)
+{
+    switch (k) {
+    case ArrowKind::Date:
+    case ArrowKind::Int:
+        return arrow::int32();
+    case ArrowKind::Minor:
+        return arrow::int64();
+    case ArrowKind::Bool:
+        return arrow::boolean();
+    case ArrowKind::Dict:
+        if (ao.dictionary) return arrow::dictionary(arrow::int32(), arrow::utf8());
+        return arrow::utf8();
+    case ArrowKind::Text:
+        break;
+    }
+    return arrow::utf8();
+}
+
+inline std::string_view arrow_trim(std::string_view s)
+{
+    while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+    while (!s.empty() && s.back() == ' ') s.remove_suffix(1);
+    return s;
+}
+
+template <class B>
+inline arrow::Status append_text(B& b, std::string_view v)
+{
+    if (v.empty()) return b.AppendNull();
+    return b.Append(v.data(), (std::int32_t)v.size());
+}
+
+// one column of t
+inline arrow::Status arrow_column(const ExportTable& t, ExportField f, const ArrowOptions& ao,
+                                  std::shared_ptr<arrow::Array>* out)
+{
+    const std::int64_t n = (std::int64_t)t.size();
+    switch (arrow_kind(f)) {
+    case ArrowKind::Date:
+    case ArrowKind::Int: {
+        const bool date = arrow_kind(f) == ArrowKind::Date;
+        arrow::Int32Builder b;
+        ARROW_RETURN_NOT_OK(b.Reserve(n));
+        for (std::size_t i = 0; i < t.size(); ++i) {
+            const int v = t.number(i, f);
+            if (v == ExportTable::kNoNumber || (date && v == 0)) b.UnsafeAppendNull();
+            else b.UnsafeAppend(v);
+        }
+        return b.Finish(out);
+    }
+    case ArrowKind::Minor: {
+        const ExportField ccy = (f == ExportField::ChargesAmount) ? ExportField::ChargesCurrency : ExportField::Currency;
+        arrow::Int64Builder b;
+        ARROW_RETURN_NOT_OK(b.Reserve(n));
+        for (std::size_t i = 0; i < t.size(); ++i) {
+            const std::string_view v = arrow_trim(t.view(i, f));
+            if (v.empty()) b.UnsafeAppendNull();
+            else b.UnsafeAppend(dec_to_minor(v, ccy_exp(t.view(i, ccy))));
+        }
+        return b.Finish(out);
+    }
+    case ArrowKind::Bool: {
+        arrow::BooleanBuilder b;
+        ARROW_RETURN_NOT_OK(b.Reserve(n));
+        for (std::size_t i = 0; i < t.size(); ++i) {
+            const std::string_view v = t.view(i, f);
+            if (v.empty()) b.UnsafeAppendNull();
+            else b.UnsafeAppend(v == "1" || v == "CRDT");
+        }
+        return b.Finish(out);
+    }
+    case ArrowKind::Dict:
+        if (ao.dictionary) {
+            arrow::StringDictionary32Builder b;
+            for (std::size_t i = 0; i < t.size(); ++i)
+                ARROW_RETURN_NOT_OK(append_text(b, t.view(i, f, ao.canonical_text)));
+            return b.Finish(out);
+        }
+        break;
+    case ArrowKind::Text:
+        break;
+    }
+    arrow::StringBuilder b;
+    ARROW_RETURN_NOT_OK(b.Reserve(n));
+    for (std::size_t i = 0; i < t.size(); ++i)
+        ARROW_RETURN_NOT_OK(append_text(b, t.view(i, f, ao.canonical_text)));
+    return b.Finish(out);
+}
+
+inline bool arrow_fail(std::string* error, const arrow::Status& st)
+{
+    if (error) *error = st.ToString();
+    return false;
+}
+} // namespace detail
+
+// schema of the selected columns (ExportOptions::columns)
+inline std::shared_ptr<arrow::Schema> arrow_schema(const ExportOptions& opt = {}, const ArrowOptions& ao = {})
+{
+    arrow::FieldVector fields;
+    for (std::size_t c = 0; c < ExportTable::kColumns; ++c) {
+        if (!opt.columns.test(c)) continue;
+        const ExportField f = static_cast<ExportField>(c);
+        fields.push_back(arrow::field(export_field_name(f, opt.credit_as_bool),
+                                      detail::arrow_type(detail::arrow_kind(f), ao)));
+    }
+    return arrow::schema(fields);
+}
+
+// rows of an ExportTable (export_entries_table() with the same opt)
+inline bool to_arrow(const ExportTable& t, std::shared_ptr<arrow::Table>& out, const ExportOptions& opt = {},
+                     const ArrowOptions& ao = {}, std::string* error = nullptr)
+{
+    arrow::ArrayVector columns;
+    for (std::size_t c = 0; c < ExportTable::kColumns; ++c) {
+        if (!opt.columns.test(c)) continue;
+        std::shared_ptr<arrow::Array> a;
+        const arrow::Status st = detail::arrow_column(t, static_cast<ExportField>(c), ao, &a);
+        if (!st.ok()) return detail::arrow_fail(error, st);
+        columns.push_back(std::move(a));
+    }
+    out = arrow::Table::Make(arrow_schema(opt, ao), columns, (std::int64_t)t.size());
+    return true;
+}
+
+inline bool export_entries_arrow(const Document& doc, std::shared_ptr<arrow::Table>& out, const ExportOptions& opt = {},
+                                 const ArrowOptions& ao = {}, std::string* error = nullptr)
+{
+    ExportTable t;
+    export_entries_table(doc, t, opt);
+    return to_arrow(t, out, opt, ao, error);
+}
+
+// Parquet file of the rows of any number of documents. Rows are collected
+// until a row group (ArrowOptions::rowGroupRows) is full, so small documents
+// do not produce small row groups; close() writes the rest and the footer.
+class ParquetWriter {
+public:
+    explicit ParquetWriter(const ExportOptions& opt = {}, const ArrowOptions& ao = {}) : opt_(opt), ao_(ao) {}
+    ~ParquetWriter() { close(); }
+
+    ParquetWriter(const ParquetWriter&) = delete;
+    ParquetWriter& operator=(const ParquetWriter&) = delete;
+
+    bool open(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        close();
+        const std::string native = std::filesystem::u8path(utf8Path).string();
+        auto file = arrow::io::FileOutputStream::Open(native);
+        if (!file.ok()) return detail::arrow_fail(error, file.status());
+
+        parquet::WriterProperties::Builder props;
+        props.compression(ao_.compression);
+        props.max_row_group_length(ao_.rowGroupRows);
+        parquet::ArrowWriterProperties::Builder arrowProps;
+        arrowProps.store_schema(); // dictionary columns are read back as such
+
+        auto writer = parquet::arrow::FileWriter::Open(*arrow_schema(opt_, ao_), arrow::default_memory_pool(),
+                                                       *file, props.build(), arrowProps.build());
+        if (!writer.ok()) {
+            (void)(*file)->Close();
+            return detail::arrow_fail(error, writer.status());
+        }
+        file_ = std::move(*file);
+        writer_ = std::move(*writer);
+        return true;
+    }
+
+    bool is_open() const { return writer_ != nullptr; }
+
+    bool write(const Document& doc, std::string* error = nullptr)
+    {
+        if (!writer_) {
+            if (error) *error = "Parquet file is not open";
+            return false;
+        }
+        std::shared_ptr<arrow::Table> t;
+        if (!export_entries_arrow(doc, t, opt_, ao_, error)) return false;
+        pending_.push_back(std::move(t));
+        pendingRows_ += pending_.back()->num_rows();
+        return pendingRows_ < ao_.rowGroupRows || flush(false, error);
+    }
+
+    // writes the remaining rows and the footer; false if that failed
+    bool close(std::string* error = nullptr)
+    {
+        if (!writer_) return true;
+        bool ok = flush(true, error);
+        arrow::Status st = writer_->Close();
+        if (st.ok()) st = file_->Close();
+        if (ok && !st.ok()) ok = detail::arrow_fail(error, st);
+        writer_.reset();
+        file_.reset();
+        pending_.clear();
+        pendingRows_ = 0;
+        return ok;
+    }
+
+private:
+    // full row groups; with all, the rest as well
+    bool flush(bool all, std::string* error)
+    {
+        if (pendingRows_ == 0) return true;
+        auto joined = arrow::ConcatenateTables(pending_);
+        if (!joined.ok()) return detail::arrow_fail(error, joined.status());
+        const std::shared_ptr<arrow::Table> t = *joined;
+        pending_.clear();
+
+        const std::int64_t group = ao_.rowGroupRows > 0 ? ao_.rowGroupRows : pendingRows_;
+        const std::int64_t n = all ? pendingRows_ : pendingRows_ - pendingRows_ % group;
+        const arrow::Status st = writer_->WriteTable(*t->Slice(0, n), group);
+        if (!st.ok()) return detail::arrow_fail(error, st);
+        if (n < pendingRows_) pending_.push_back(t->Slice(n));
+        pendingRows_ -= n;
+        return true;
+    }
+
+    ExportOptions opt_;
+    ArrowOptions ao_;
+    std::shared_ptr<arrow::io::FileOutputStream> file_;
+    std::unique_ptr<parquet::arrow::FileWriter> writer_;
+    std::vector<std::shared_ptr<arrow::Table>> pending_;
+    std::int64_t pendingRows_ = 0;
+};
+
+} // namespace camt
+
+#endif // USE_ARROW
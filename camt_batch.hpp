@@ -0,0 +1,267 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_model.hpp"
+#include "camt_parser_pugi.hpp"
+#include "camt_csv.hpp"
+#include "camt_thread_pool.hpp"
+#include "camt_archive.hpp"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace camt {
+
+// ---------- Batch ingestion ----------
+struct BatchOptions {
+    unsigned threads = 0;          // worker threads, 0 = hardware concurrency
+    bool ordered = false;          // deliver results in input order (else as they finish)
+    std::size_t maxInFlight = 0;   // files being parsed or awaiting delivery, 0 = 2 * threads
+
+    // filter, sections and pool of every parse. The workers share one Parser,
+    // so parseOptions.stats (like exportOptions.stats) is only safe with one
+    // thread: Stats is not synchronized.
+    ParseOptions parseOptions;
+
+    bool exportRows = false;       // fill BatchResult::rows with export_entries_csv()
+    bool keepDocument = true;      // false: only the rows are delivered
+    ExportOptions exportOptions;
+
+    // parse_directory() / parse_archive(): file filter (case-insensitive, empty = every regular file)
+    std::string extension = ".xml";
+    bool recursive = false;
+};
+
+struct BatchResult {
+    std::size_t index = 0;         // position in the input list (parse_archive(): among its members)
+    std::string path;
+    std::string member;            // parse_archive(): name of the ZIP member
+    bool ok = false;
+    std::string error;             // set if !ok
+    Document document;
+    ExportData rows;               // if BatchOptions::exportRows
+};
+
+struct BatchStats {
+    std::size_t files = 0;         // delivered results
+    std::size_t failed = 0;
+    bool stopped = false;          // the callback returned false
+};
+
+// Parses many files concurrently. The files are parsed on a work-stealing
+// pool, the callback runs on the calling thread (never concurrently), so it
+// can write to a shared CSV stream or database without locking. At most
+// maxInFlight results exist at a time, which bounds the memory also when
+// 'ordered' has to hold back results behind a slow file.
+class BatchParser {
+public:
+    // return false to stop: no further files are started, running ones are discarded
+    using Callback = std::function<bool(BatchResult&&)>;
+
+    explicit BatchParser(BatchOptions opt = {})
+        : opt_(std::move(opt)), parser_(opt_.parseOptions), pool_(opt_.threads)
+    {
+    }
+
+    const BatchOptions& options() const { return opt_; }
+    ThreadPool& pool() { return pool_; }
+
+    BatchStats parse_files(const std::vector<std::string>& utf8Paths, const Callback& cb)
+    {
+        return run(utf8Paths.size(), [&](std::size_t i) {
+            return parse_one(i, utf8Paths[i], std::string(), [&](Document& doc, std::string* err) {
+                return parser_.parse_mapped_file(utf8Paths[i], doc, err);
+            });
+        }, cb);
+    }
+
+    // parses the members of a ZIP archive that match the extension filter
+    // (index = position among them); they are decompressed on the workers, in
+    // memory. False only if the archive cannot be opened.
+    bool parse_archive(const std::string& utf8Zip, const Callback& cb,
+                       BatchStats* stats = nullptr, std::string* error = nullptr)
+    {
+        ZipArchive zip;
+        if (!zip.open(utf8Zip, error)) {
+            return false;
+        }
+        std::vector<std::size_t> members;
+        for (std::size_t i = 0; i < zip.size(); ++i) {
+            const ZipMember& m = zip.members()[i];
+            if (!m.is_directory() && (opt_.extension.empty() || has_extension(m.name, opt_.extension)))
+                members.push_back(i);
+        }
+        const BatchStats s = run(members.size(), [&](std::size_t k) {
+            const std::size_t i = members[k];
+            return parse_one(k, utf8Zip, zip.members()[i].name, [&](Document& doc, std::string* err) {
+                std::string xml;
+                return zip.extract(i, xml, err) && parser_.parse_buffer_inplace(&xml[0], xml.size(), doc, err);
+            });
+        }, cb);
+        if (stats) *stats = s;
+        return true;
+    }
+
+    // parses the files of a directory (sorted by path); false only if listing failed
+    bool parse_directory(const std::string& utf8Dir, const Callback& cb,
+                         BatchStats* stats = nullptr, std::string* error = nullptr)
+    {
+        std::vector<std::string> files;
+        if (!list_files(utf8Dir, files, error)) {
+            return false;
+        }
+        const BatchStats s = parse_files(files, cb);
+        if (stats) *stats = s;
+        return true;
+    }
+
+    // regular files below utf8Dir matching the extension filter, sorted
+    bool list_files(const std::string& utf8Dir, std::vector<std::string>& out, std::string* error = nullptr) const
+    {
+        const std::filesystem::path dir = std::filesystem::u8path(utf8Dir);
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec)) {
+            if (error) {
+                *error = std::string("Not a directory: '") + utf8Dir + "'";
+            }
+            return false;
+        }
+
+        auto wanted = [&](const std::filesystem::directory_entry& de) {
+            std::error_code fec;
+            if (!de.is_regular_file(fec)) return false;
+            if (opt_.extension.empty()) return true;
+            std::string ext = de.path().extension().u8string();
+            if (ext.size() != opt_.extension.size()) return false;
+            return std::equal(ext.begin(), ext.end(), opt_.extension.begin(), [](char a, char b){
+                return std::tolower((unsigned char)a) == std::tolower((unsigned char)b);
+            });
+        };
+
+        out.clear();
+        if (opt_.recursive) {
+            std::filesystem::recursive_directory_iterator it(dir, ec), end;
+            for (; !ec && it != end; it.increment(ec))
+                if (wanted(*it)) out.push_back(it->path().u8string());
+        } else {
+            std::filesystem::directory_iterator it(dir, ec), end;
+            for (; !ec && it != end; it.increment(ec))
+                if (wanted(*it)) out.push_back(it->path().u8string());
+        }
+        if (ec) {
+            if (error) {
+                *error = std::string("Cannot list directory '") + utf8Dir + "': " + ec.message();
+            }
+            return false;
+        }
+        std::sort(out.begin(), out.end());
+        return true;
+    }
+
+private:
+    // schedules job(0) .. job(n - 1) on the pool and delivers the results
+    BatchStats run(std::size_t n, const std::function<BatchResult(std::size_t)>& job, const Callback& cb)
+    {
+        BatchStats stats;
+        const std::size_t maxInFlight = opt_.maxInFlight ? opt_.maxInFlight : 2 * (std::size_t)pool_.size();
+
+        // results handed from the workers to this thread
+        struct Channel {
+            std::mutex m;
+            std::condition_variable cv;
+            std::deque<BatchResult> done;
+        } ch;
+
+        std::size_t next = 0, inFlight = 0, nextOrdered = 0;
+        std::map<std::size_t, BatchResult> parked; // ordered mode: finished out of order
+
+        auto deliver = [&](BatchResult&& r) {
+            --inFlight;
+            if (stats.stopped) return;
+            ++stats.files;
+            if (!r.ok) ++stats.failed;
+            if (!cb(std::move(r))) stats.stopped = true;
+        };
+
+        for (;;) {
+            while (!stats.stopped && next < n && inFlight < maxInFlight) {
+                const std::size_t i = next++;
+                ++inFlight;
+                pool_.submit([&ch, &job, i]{
+                    BatchResult r = job(i);
+                    // notify under the lock: ch lives on the caller's stack
+                    std::lock_guard<std::mutex> lk(ch.m);
+                    ch.done.push_back(std::move(r));
+                    ch.cv.notify_one();
+                });
+            }
+            if (inFlight == 0) break;
+
+            std::deque<BatchResult> batch;
+            {
+                std::unique_lock<std::mutex> lk(ch.m);
+                ch.cv.wait(lk, [&]{ return !ch.done.empty(); });
+                batch.swap(ch.done);
+            }
+            for (BatchResult& r : batch) {
+                if (!opt_.ordered) {
+                    deliver(std::move(r));
+                    continue;
+                }
+                const std::size_t idx = r.index;
+                parked.emplace(idx, std::move(r));
+                for (auto it = parked.find(nextOrdered); it != parked.end(); it = parked.find(nextOrdered)) {
+                    BatchResult out = std::move(it->second);
+                    parked.erase(it);
+                    ++nextOrdered;
+                    deliver(std::move(out));
+                }
+            }
+        }
+        return stats;
+    }
+
+    BatchResult parse_one(std::size_t index, const std::string& path, std::string member,
+                          const std::function<bool(Document&, std::string*)>& parse) const
+    {
+        BatchResult r;
+        r.index = index;
+        r.path = path;
+        r.member = std::move(member);
+        try {
+            r.ok = parse(r.document, &r.error);
+            if (r.ok && opt_.exportRows) {
+                export_entries_csv(r.document, nullptr, &r.rows, opt_.exportOptions);
+                if (!opt_.keepDocument) r.document = Document();
+            }
+        } catch (const std::exception& e) {
+            r.ok = false;
+            const std::string name = r.member.empty() ? path : path + ": " + r.member;
+            r.error = std::string("Exception while parsing '") + name + "': " + e.what();
+        }
+        return r;
+    }
+
+    BatchOptions opt_;
+    Parser parser_;
+    ThreadPool pool_;
+};
+
+} // namespace camt
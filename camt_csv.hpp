@@ -12,25 +12,92 @@
 #include "camt_model.hpp"
 #include "camt_parser_pugi.hpp"
 #include "gvc_map.hpp"
+#include "camt_csv_writer.hpp"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <iomanip>
 #include <sstream>
 #include <charconv>
 #ifdef USE_UTF8PROC
 #include <utf8proc.h>
-#include <memory>
 #endif
 
 namespace camt {
 
-#ifdef USE_UTF8PROC
+// ---------- ASCII fast path for free text ----------
+namespace detail {
+inline constexpr std::uint64_t kOnes  = 0x0101010101010101ull;
+inline constexpr std::uint64_t kHighs = 0x8080808080808080ull;
+
+// length of the leading 7-bit part of [p, e), 8 bytes per step
+inline std::size_t ascii_prefix(const char* p, const char* e) {
+    const char* const b = p;
+    for (; e - p >= 8; p += 8) {
+        std::uint64_t x;
+        std::memcpy(&x, p, 8);
+        if (x & kHighs) break;
+    }
+    while (p < e && (unsigned char)*p < 0x80) ++p;
+    return (std::size_t)(p - b);
+}
 
-    // RAII deleter for buffers allocated by utf8proc_map (uses malloc internally)
-    struct Utf8ProcDeleter {
-        void operator()(utf8proc_uint8_t* p) const noexcept { if (p) free(p); }
+inline bool ascii_ws(unsigned char c) {
+    return c == ' ' || (c >= 0x09 && c <= 0x0D);
+}
+
+// Appends text with ASCII whitespace removed and, if lower, A-Z lowercased;
+// bytes >= 0x80 are copied. 7-bit words of eight bytes are lowercased at once
+// (SWAR: bytes in 'A'..'Z' get 0x20 added) and stored whole if they contain
+// no whitespace.
+inline void ascii_freetext_to(const char* p, std::size_t n, std::string& out, bool lower) {
+    const std::size_t start = out.size();
+    out.resize(start + n);
+    char* d = &out[start];
+    const char* const e = p + n;
+    auto put = [&](unsigned char c) {
+        if (!ascii_ws(c)) *d++ = (char)(lower && c >= 'A' && c <= 'Z' ? c + 0x20 : c);
     };
+    for (; e - p >= 8; p += 8) {
+        std::uint64_t x;
+        std::memcpy(&x, p, 8);
+        if (x & kHighs) { // the byte-wise sums below would carry
+            for (int i = 0; i < 8; ++i) put((unsigned char)p[i]);
+            continue;
+        }
+        if (lower) {
+            const std::uint64_t upper = (x + kOnes * (0x80 - 'A')) & ~(x + kOnes * (0x80 - 'Z' - 1)) & kHighs;
+            x |= upper >> 2;
+        }
+        const std::uint64_t sp = x ^ (kOnes * ' ');
+        const std::uint64_t ctl = (x + kOnes * (0x80 - 0x09)) & ~(x + kOnes * (0x80 - 0x0E)) & kHighs;
+        if ((((sp - kOnes) & ~sp & kHighs) | ctl) == 0) {
+            std::memcpy(d, &x, 8);
+            d += 8;
+            continue;
+        }
+        char w[8];
+        std::memcpy(w, &x, 8);
+        for (char c : w)
+            if (!ascii_ws((unsigned char)c)) *d++ = c;
+    }
+    for (; p < e; ++p) put((unsigned char)*p);
+    out.resize((std::size_t)(d - out.data()));
+}
+} // namespace detail
+
+#ifdef USE_UTF8PROC
 
     // Check if codepoint is considered whitespace (Unicode separators + ASCII controls)
     inline bool isUnicodeSpaceOrControlWS(utf8proc_int32_t cp) {
@@ -54,38 +121,26 @@ namespace camt {
         }
     }
 
-    inline std::string normalize_freetext(std::string_view in,
-        bool do_casefold = true,
-        bool strip_zero_width = true)
+    namespace detail {
+    // NFC (+ casefold) of one span via utf8proc, decoded into the reused
+    // code point buffer; appends the filtered result. false on invalid UTF-8.
+    inline bool utf8proc_freetext_to(std::string_view s, std::string& out,
+        utf8proc_option_t opts, bool strip_zero_width, std::vector<utf8proc_int32_t>& cps)
     {
-        utf8proc_uint8_t* raw = nullptr;
-        utf8proc_option_t opts = UTF8PROC_COMPOSE; // NFC
-        if (do_casefold) opts = (utf8proc_option_t)(opts | UTF8PROC_CASEFOLD);
-
-        const utf8proc_ssize_t nlen = utf8proc_map(
-            reinterpret_cast<const utf8proc_uint8_t*>(in.data()),
-            static_cast<utf8proc_ssize_t>(in.size()),
-            &raw, opts
-        );
-        if (nlen < 0 || !raw) {
-            return std::string(in); // Fallback: return original input
+        const auto* src = reinterpret_cast<const utf8proc_uint8_t*>(s.data());
+        const auto len = static_cast<utf8proc_ssize_t>(s.size());
+        utf8proc_ssize_t n = utf8proc_decompose(src, len, cps.data(), (utf8proc_ssize_t)cps.size(), opts);
+        if (n < 0) return false;
+        if ((std::size_t)n > cps.size()) {
+            cps.resize((std::size_t)n);
+            n = utf8proc_decompose(src, len, cps.data(), n, opts);
+            if (n < 0) return false;
         }
-        std::unique_ptr<utf8proc_uint8_t, Utf8ProcDeleter> norm(raw);
+        n = utf8proc_normalize_utf32(cps.data(), n, opts); // composition
+        if (n < 0) return false;
 
-        std::string out;
-        out.reserve(static_cast<size_t>(nlen));
-        const utf8proc_uint8_t* p   = norm.get();
-        const utf8proc_uint8_t* end = norm.get() + nlen;
-
-        while (p < end) {
-            utf8proc_int32_t cp = 0;
-            const utf8proc_ssize_t adv =
-                utf8proc_iterate(p, (utf8proc_ssize_t)(end - p), &cp);
-            if (adv <= 0) { // Skip invalid byte
-                ++p;
-                continue;
-            }
-            p += adv;
+        for (utf8proc_ssize_t i = 0; i < n; ++i) {
+            const utf8proc_int32_t cp = cps[(std::size_t)i];
 
             // Remove Unicode and ASCII whitespace
             if (isUnicodeSpaceOrControlWS(cp)) {
@@ -111,7 +166,51 @@ namespace camt {
                 out.append(reinterpret_cast<char*>(buf), (size_t)w);
             }
         }
+        return true;
+    }
+    } // namespace detail
+
+    // NFC + casefold + strip whitespace/zero-width into 'out' (replaced; its
+    // capacity is reused). 7-bit runs take the ASCII path; each non-ASCII run
+    // goes through utf8proc together with the ASCII character before it, which
+    // may be the base of a combining mark. Invalid UTF-8 yields the input.
+    inline void normalize_freetext_to(std::string_view in, std::string& out,
+        bool do_casefold = true,
+        bool strip_zero_width = true)
+    {
+        static thread_local std::vector<utf8proc_int32_t> cps;
+        utf8proc_option_t opts = UTF8PROC_COMPOSE; // NFC
+        if (do_casefold) opts = (utf8proc_option_t)(opts | UTF8PROC_CASEFOLD);
+
+        out.clear();
+        const char* p = in.data();
+        const char* const e = p + in.size();
+        while (p < e) {
+            std::size_t a = detail::ascii_prefix(p, e);
+            if (p + a == e) {
+                detail::ascii_freetext_to(p, a, out, do_casefold);
+                break;
+            }
+            if (a) --a; // keep the possible base character with the run
+            detail::ascii_freetext_to(p, a, out, do_casefold);
+            p += a;
+
+            const char* q = p + 1;
+            while (q < e && (unsigned char)*q >= 0x80) ++q;
+            if (!detail::utf8proc_freetext_to(std::string_view(p, (std::size_t)(q - p)), out, opts, strip_zero_width, cps)) {
+                out.assign(in.data(), in.size()); // Fallback: return original input
+                return;
+            }
+            p = q;
+        }
+    }
 
+    inline std::string normalize_freetext(std::string_view in,
+        bool do_casefold = true,
+        bool strip_zero_width = true)
+    {
+        std::string out;
+        normalize_freetext_to(in, out, do_casefold, strip_zero_width);
         return out;
     }
 
@@ -121,58 +220,31 @@ namespace camt {
     // - strips ASCII whitespace
     // - lowercases A–Z
     // - leaves all non-ASCII bytes untouched
+    inline void normalize_freetext_to(std::string_view in, std::string& out, bool do_casefold = true, bool strip_zero_width = true) {
+        (void)do_casefold; (void)strip_zero_width;
+        out.clear();
+        detail::ascii_freetext_to(in.data(), in.size(), out, true); // bytes >= 0x80 pass unchanged
+    }
+
     inline std::string normalize_freetext(std::string_view in, bool do_casefold = true, bool strip_zero_width = true) {
         std::string out;
-        out.reserve(in.size());
-        for (unsigned char c : in) {
-            if (c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\f' || c=='\v')
-                continue;
-            if (c < 0x80) {
-                out.push_back(static_cast<char>(std::tolower(c)));
-            } else {
-                out.push_back(static_cast<char>(c)); // keep UTF-8 byte
-            }
-        }
+        normalize_freetext_to(in, out, do_casefold, strip_zero_width);
         return out;
     }
 
 #endif // USE_UTF8PROC
 
 
-struct ExportOptions {
-    char delimiter = ';';          
-    bool include_header = true;
-    bool write_utf8_bom = false;   // Excel-compatible
-    
-    // true  => amount with sign (CRDT=+ / DBIT=-)
-    // false => amount always positive, sign only in "CreditDebit"
-    bool signed_amount = true;
-
-    //CSV column as Bool (1/0) instead of "CRDT"/"DBIT"
-    bool credit_as_bool = true;  // true => "IsCredit"; false => "CreditDebit"
-    std::string remittance_separator; // = " | ";
-
-    bool use_effective_credit = false;
-    bool prefer_ultimate_counterparty = true;
-};
+using CAMTRow = std::vector<std::pair<std::string,std::string>>;
 
 inline std::string csv_escape(const std::string& s, char delimiter) {
-    bool needQuotes = s.find(delimiter) != std::string::npos ||
-                      s.find('"')       != std::string::npos ||
-                      s.find('\n')      != std::string::npos ||
-                      s.find('\r')      != std::string::npos;
-    std::string out = s;
-    // double quotes
-    for (size_t pos = 0; (pos = out.find('"', pos)) != std::string::npos; pos += 2)
-        out.insert(pos, "\"");
-    if (needQuotes) {
-        out.insert(out.begin(), '"');
-        out.push_back('"');
-    }
+    std::string out;
+    out.reserve(s.size());
+    csv_escape_to(s, delimiter, [&](const char* p, std::size_t n) { out.append(p, n); });
     return out;
 }
 
-// CurrencyAmount -> "123,45" / "123.45"
+// CurrencyAmount -> "123,45" / "123.45" (to_chars into a stack buffer)
 inline std::string fmt_amount(const CurrencyAmount& a, bool use_decimal_comma=false) {
     const int exp = ccy_exp(a.currency);
     int64_t v = a.minor;
@@ -181,14 +253,19 @@ inline std::string fmt_amount(const CurrencyAmount& a, bool use_decimal_comma=fa
     int64_t major = v / pow10;
     int64_t frac  = v % pow10;
 
-    std::ostringstream oss;
-    if (neg) oss << '-';
-    oss << major;
+    char buf[48];
+    char* p = buf;
+    char* const end = buf + sizeof(buf);
+    if (neg) *p++ = '-';
+    p = std::to_chars(p, end, major).ptr;
     if (exp > 0) {
-        oss << (use_decimal_comma ? ',' : '.')
-            << std::setw(exp) << std::setfill('0') << frac;
+        *p++ = use_decimal_comma ? ',' : '.';
+        char digits[24];
+        char* const de = std::to_chars(digits, digits + sizeof(digits), frac).ptr;
+        for (std::ptrdiff_t pad = exp - (de - digits); pad > 0; --pad) *p++ = '0';
+        for (const char* d = digits; d < de; ++d) *p++ = *d;
     }
-    return oss.str();
+    return std::string(buf, (std::size_t)(p - buf));
 }
 
 struct ChargesSummary {
@@ -203,7 +280,6 @@ inline int64_t apply_sign(int64_t minor, bool hasInd, bool isCredit) {
 }
 
 
-using CAMTRow = std::vector<std::pair<std::string,std::string>>;
 using ExportData = std::vector<CAMTRow>;
 
 enum class ExportField { 
@@ -247,6 +323,100 @@ constexpr std::size_t to_index(ExportField f) noexcept {
     return static_cast<std::size_t>(f);
 }
 
+// column title of the export header
+inline const char* export_field_name(ExportField f, bool credit_as_bool = true) {
+    static const char* const names[] = {
+        "BookingDate", "ValueDate", "Amount", "CreditDebit", "Currency",
+        "CounterpartyName", "CounterpartyIBAN", "CounterpartyBIC", "RemittanceLine", "RemittanceStructured",
+        "EndToEndId", "MandateId", "TxId", "BankRef", "AccountIBAN",
+        "AccountBIC", "BkTxCd", "BookingCode", "Status", "Reversal",
+        "RunningBalance", "ServicerBankName", "OpeningBalance", "ClosingBalance", "Primanota",
+        "DTACode", "GVCCode", "SWIFTTransactionCode", "ChargesAmount", "ChargesCurrency",
+        "ChargesIncluded", "EntryOrdinal", "TxOrdinal"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == to_index(ExportField::Count), "export_field_name");
+    if (f == ExportField::CreditDebit && credit_as_bool) return "IsCredit";
+    return to_index(f) < to_index(ExportField::Count) ? names[to_index(f)] : "";
+}
+
+// set of export columns, bit to_index(f) per field
+using ExportColumns = std::bitset<static_cast<std::size_t>(ExportField::Count)>;
+
+inline ExportColumns export_columns(std::initializer_list<ExportField> fields) {
+    ExportColumns c;
+    for (ExportField f : fields) c.set(to_index(f));
+    return c;
+}
+
+// ParseSection flags the columns need (for ParseOptions::sections)
+inline unsigned parse_sections_for(const ExportColumns& c) {
+    using F = ExportField;
+    auto any = [&](std::initializer_list<F> fs) {
+        for (F f : fs) if (c.test(to_index(f))) return true;
+        return false;
+    };
+    unsigned s = 0;
+    if (any({F::CounterpartyName, F::CounterpartyIBAN})) s |= SectionParties;
+    if (any({F::CounterpartyBIC})) s |= SectionAgents;
+    if (any({F::RemittanceLine, F::RemittanceStructured})) s |= SectionRemittance;
+    if (any({F::ChargesAmount, F::ChargesCurrency, F::ChargesIncluded})) s |= SectionCharges;
+    if (any({F::BkTxCd, F::BookingCode, F::Primanota, F::DTACode, F::GVCCode, F::SWIFTTransactionCode})) s |= SectionCodes;
+    if (any({F::OpeningBalance, F::ClosingBalance})) s |= SectionBalances;
+    return s;
+}
+
+struct ExportOptions {
+    char delimiter = ';';          
+    bool include_header = true;
+    bool write_utf8_bom = false;   // Excel-compatible
+    
+    // true  => amount with sign (CRDT=+ / DBIT=-)
+    // false => amount always positive, sign only in "CreditDebit"
+    bool signed_amount = true;
+
+    //CSV column as Bool (1/0) instead of "CRDT"/"DBIT"
+    bool credit_as_bool = true;  // true => "IsCredit"; false => "CreditDebit"
+    std::string remittance_separator; // = " | ";
+
+    bool use_effective_credit = false;
+    bool prefer_ultimate_counterparty = true;
+
+    // columns to compute and write; the others stay empty in the rows (see
+    // export_columns()). The CSV contains the selected columns only.
+    ExportColumns columns = ExportColumns().set();
+
+    // > 0: LRU cache of that many normalized counterparty names (FreetextCache);
+    // worth it with utf8proc and non-ASCII names, ASCII is faster uncached
+    std::size_t name_cache_size = 0;
+
+    // called for every finished row (canonical values filled in); returning
+    // false drops it from all outputs, e.g. DedupIndex::export_filter()
+    std::function<bool(CAMTRow& row)> row_filter;
+
+    // start value (minor units) of RunningBalance per statement, 0 if empty;
+    // IncrementalSession::export_options() continues earlier reports with it
+    std::function<std::int64_t(const Statement& st)> running_balance_start;
+
+    // currency of RunningBalance for accounts without one; empty: that of the
+    // statement's first row
+    std::string running_balance_currency;
+
+    // false: the document holds a middle part of a statement (Pipeline), so
+    // its first row gets no global OpeningBalance / its last no ClosingBalance
+    bool statement_starts = true;
+    bool statement_ends = true;
+
+    // filled in with rows and normalize/GVC/CSV/export times; only with CAMT_STATS
+    Stats* stats = nullptr;
+
+    // Formats the rows concurrently on this pool, in parts of entriesPerTask
+    // entries (nullptr = sequential). Output and row order are the same as in
+    // sequential mode; the per-phase times are then not recorded.
+    ThreadPool* pool = nullptr;
+    std::size_t parallelMinEntries = 512;  // smaller documents stay sequential
+    std::size_t entriesPerTask = 256;
+};
+
 // ----------------------- minimal ASCII utilities (UTF-8 safe)" ------------------
 inline std::string ascii_trim(std::string_view s) {
     size_t b = 0, e = s.size();
@@ -343,6 +513,46 @@ inline std::string normalize_field(ExportField f, std::string_view v)
     }
 }
 
+// ---------- Normalized-name cache ----------
+// Small LRU of normalize_freetext() results. Counterparty names repeat
+// heavily within and across statements, so most lookups hit and skip the
+// normalization. Evicted entries are reused, keeping their buffers.
+class FreetextCache {
+public:
+    explicit FreetextCache(std::size_t capacity = 256) : cap_(capacity ? capacity : 1) { index_.reserve(cap_); }
+
+    FreetextCache(const FreetextCache&) = delete;
+    FreetextCache& operator=(const FreetextCache&) = delete;
+
+    // normalize_freetext(v); valid until the next call
+    const std::string& normalize(std::string_view v)
+    {
+        if (auto it = index_.find(v); it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->value;
+        }
+        if (lru_.size() < cap_) {
+            lru_.emplace_front();
+        } else {
+            index_.erase(lru_.back().key);
+            lru_.splice(lru_.begin(), lru_, std::prev(lru_.end()));
+        }
+        Item& item = lru_.front();
+        item.key.assign(v.data(), v.size());
+        normalize_freetext_to(v, item.value);
+        index_.emplace(item.key, lru_.begin());
+        return item.value;
+    }
+
+    std::size_t size() const { return lru_.size(); }
+
+private:
+    struct Item { std::string key, value; };
+    std::size_t cap_;
+    std::list<Item> lru_;  // most recent first
+    std::unordered_map<std::string_view, std::list<Item>::iterator> index_;  // views into lru_ keys
+};
+
 // Unified normalize_row
 inline void normalize_or_accumulate_row(
     CAMTRow& row,
@@ -446,7 +656,116 @@ inline bool sortExportData(ExportData& rows, bool hasTitle, bool useBookingDate)
 }
 #endif
 
-inline bool sortExportData(ExportData& rows, bool hasTitle, bool useBookingDate)
+namespace detail {
+// signed amount of the entry's rows, as export_entries_csv() adds it to RunningBalance
+inline std::int64_t running_contribution(const Entry& e)
+{
+    auto row = [&](const EntryTransaction* tx) {
+        const bool credit = (tx && tx->hasCdtDbtInd) ? tx->isCredit : e.isCredit;
+        const std::int64_t m = (tx && tx->txAmount.has_value()) ? tx->txAmount->minor : e.amount.minor;
+        const std::int64_t abs = m < 0 ? -m : m;
+        return (e.reversal ? !credit : credit) ? abs : -abs;
+    };
+    if (e.transactions.empty()) return row(nullptr);
+    std::int64_t sum = 0;
+    for (const auto& tx : e.transactions) sum += row(&tx);
+    return sum;
+}
+
+// Running balance in minor units: the scale grows to the largest currency
+// exponent seen, the result is printed without trailing zeros. Formatting
+// works on stack buffers.
+struct RunningBalance {
+    int64_t v = 0;
+    int scale = 0;
+
+    static std::string fmt_scaled(int64_t v, int scale){
+        bool neg = v<0; uint64_t u = neg? (uint64_t)(-v) : (uint64_t)v;
+        char d[24];
+        const std::size_t nd = (std::size_t)(std::to_chars(d, d + sizeof(d), u).ptr - d);
+        char out[48];
+        std::size_t n = 0;
+        if (neg) out[n++] = '-';
+        if (scale <= 0) {
+            std::memcpy(out + n, d, nd);
+            return std::string(out, n + nd);
+        }
+        const std::size_t sc = (std::size_t)scale;
+        // digits padded to at least scale+1, split before the last 'scale'
+        const std::size_t pad = nd <= sc ? sc + 1 - nd : 0;
+        const std::size_t total = nd + pad;
+        auto digit = [&](std::size_t i){ return i < pad ? '0' : d[i - pad]; };
+        std::size_t end = total; // strip trailing zeros of the fraction
+        while (end > total - sc && digit(end - 1) == '0') --end;
+        if (n + end + 1 > sizeof(out)) return std::string(); // scale beyond int64 digits
+        for (std::size_t i = 0; i < total - sc; ++i) out[n++] = digit(i);
+        if (end > total - sc) {
+            out[n++] = '.';
+            for (std::size_t i = total - sc; i < end; ++i) out[n++] = digit(i);
+        }
+        return std::string(out, n);
+    }
+
+    // adds sign * minor (minor units at exponent exp), returns the new
+    // balance as text
+    std::string add(int64_t minor, int exp, int sign){
+        if (exp > scale) { for(int k=0;k<exp-scale;++k) { v *= 10; } scale = exp; }
+        for (int k = exp; k < scale; ++k) minor *= 10;
+        v += sign * minor;
+        return fmt_scaled(v, scale);
+    }
+};
+
+// Amount.second of an export row in minor units at the exponent of its
+// Currency, read once when the row's sort key is built
+inline int64_t row_amount_minor(std::string_view amount, std::string_view currency, int& exp){
+    exp = ccy_exp(currency);
+    return dec_to_minor(amount, exp);
+}
+
+// Sort key of an export row, built once per row: date, rank of the account
+// IBAN in lexicographic order, entry and transaction ordinal. 'pos' (the
+// original index) makes the order total, so an unstable sort gives the
+// result of std::stable_sort. 'amount' (minor units at exponent 'exp')
+// feeds the running balance and takes no part in the order.
+struct ExportSortKey {
+    int64_t date = 0;
+    uint32_t iban = 0;
+    int64_t entry = 0;
+    int64_t tx = 0;
+    std::size_t pos = 0;
+    int64_t amount = 0;
+    int exp = 0;
+
+    bool operator<(const ExportSortKey& o) const {
+        if (date != o.date) return date < o.date;
+        if (iban != o.iban) return iban < o.iban;
+        if (entry != o.entry) return entry < o.entry;
+        if (tx != o.tx) return tx < o.tx;
+        return pos < o.pos;
+    }
+};
+
+// ids[i] -> rank of texts[ids[i]] among the distinct texts (sorted)
+inline std::vector<uint32_t> rank_texts(const std::vector<std::string_view>& texts) {
+    std::vector<uint32_t> byText(texts.size());
+    for (uint32_t i = 0; i < byText.size(); ++i) byText[i] = i;
+    std::sort(byText.begin(), byText.end(), [&](uint32_t a, uint32_t b){ return texts[a] < texts[b]; });
+    std::vector<uint32_t> rank(texts.size());
+    uint32_t r = 0;
+    for (std::size_t i = 0; i < byText.size(); ++i) {
+        if (i && texts[byText[i]] != texts[byText[i-1]]) ++r;
+        rank[byText[i]] = r;
+    }
+    return rank;
+}
+} // namespace detail
+
+// Sorts by date (canonical YYYYMMDD), account IBAN, EntryOrdinal and
+// TransactionOrdinal, keeping the input order of equal rows, then recomputes
+// RunningBalance per IBAN (sign from CreditDebit.second XOR Reversal.second).
+// The keys are built once per row; with a pool the sort runs in parallel.
+inline bool sortExportData(ExportData& rows, bool hasTitle, bool useBookingDate, ThreadPool* pool = nullptr)
 {
     auto to_i64 = [](const std::string& s, int64_t d=0){
         int64_t v=d; auto [p,ec]=std::from_chars(s.data(), s.data()+s.size(), v);
@@ -457,133 +776,528 @@ inline bool sortExportData(ExportData& rows, bool hasTitle, bool useBookingDate)
     const size_t off = hasTitle ? 1 : 0;
     if (rows.size() < 1 + off) { return true; }
     if (rows[off].size() < n)  { return false; }
+    const size_t count = rows.size() - off;
+
+    // 1) Keys: Datum (YYYYMMDD second), IBAN, EntryOrdinal, TransactionOrdinal,
+    //    plus the amount in minor units for step 2
+    const auto keyDate = useBookingDate ? ExportField::BookingDate : ExportField::ValueDate;
+    std::unordered_map<std::string_view, uint32_t> ibanIds;
+    std::vector<std::string_view> ibans;
+    std::vector<detail::ExportSortKey> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        const CAMTRow& row = rows[off + i];
+        detail::ExportSortKey& k = keys[i];
+        k.date  = to_i64(row[to_index(keyDate)].second);
+        k.entry = to_i64(row[to_index(ExportField::EntryOrdinal)].second);
+        k.tx    = to_i64(row[to_index(ExportField::TransactionOrdinal)].second);
+        k.pos   = i;
+        k.amount = detail::row_amount_minor(row[to_index(ExportField::Amount)].second,
+                                            row[to_index(ExportField::Currency)].second, k.exp);
+        auto it = ibanIds.emplace(row[to_index(ExportField::AccountIBAN)].second, (uint32_t)ibans.size());
+        if (it.second) ibans.push_back(it.first->first);
+        k.iban = it.first->second;
+    }
+    const std::vector<uint32_t> rank = detail::rank_texts(ibans);
+    for (auto& k : keys) k.iban = rank[k.iban];
 
-    // 1) Sortierung: Datum (YYYYMMDD second), IBAN, EntryOrdinal, TransactionOrdinal
-    std::stable_sort(rows.begin()+static_cast<std::ptrdiff_t>(off), rows.end(),
-        [&](const auto& a, const auto& b){
-            auto keyDate = useBookingDate ? ExportField::BookingDate : ExportField::ValueDate;
-            auto da = to_i64(a[to_index(keyDate)].second);
-            auto db = to_i64(b[to_index(keyDate)].second);
-            if (da != db) return da < db;
-
-            const auto& ia = a[to_index(ExportField::AccountIBAN)].second;
-            const auto& ib = b[to_index(ExportField::AccountIBAN)].second;
-            if (ia != ib) return ia < ib;
-
-            auto eoA = to_i64(a[to_index(ExportField::EntryOrdinal)].second);
-            auto eoB = to_i64(b[to_index(ExportField::EntryOrdinal)].second);
-            if (eoA != eoB) return eoA < eoB;
+    parallel_sort(pool, keys.begin(), keys.end(), std::less<detail::ExportSortKey>());
 
-            auto toA = to_i64(a[to_index(ExportField::TransactionOrdinal)].second);
-            auto toB = to_i64(b[to_index(ExportField::TransactionOrdinal)].second);
-            return toA < toB;
-        }
-    );
+    ExportData sorted;
+    sorted.reserve(count);
+    for (const auto& k : keys) sorted.push_back(std::move(rows[off + k.pos]));
+    std::move(sorted.begin(), sorted.end(), rows.begin() + static_cast<std::ptrdiff_t>(off));
 
     // 2) Running Balance pro IBAN, mit Sign aus CreditDebit.second XOR Reversal.second
-    // Amount.second ist absoluter Betrag (Text, Punkt als Dezimaltrennzeichen).
-    auto frac = [](const std::string& s){ auto p=s.find('.'); return p==std::string::npos?0:int(s.size()-p-1); };
-    auto parse_scaled = [&](const std::string& s, int scale){
-        std::string ip=s, fp; auto p=s.find('.'); if(p!=std::string::npos){ ip=s.substr(0,p); fp=s.substr(p+1); }
-        if ((int)fp.size() < scale) fp.append(size_t(scale - (int)fp.size()), '0'); else if ((int)fp.size() > scale) fp.resize(size_t(scale));
-        if (ip.empty()) ip = "0";
-        std::string all = ip + (scale?fp:"");
-        int64_t v=0; if(!all.empty()){ auto [_,ec]=std::from_chars(all.data(), all.data()+all.size(), v); if(ec!=std::errc()) v=0; }
-        return v;
-    };
-    auto fmt_scaled = [](int64_t v, int scale){
-        bool neg = v<0; uint64_t u = neg? (uint64_t)(-v) : (uint64_t)v;
-        std::string s = std::to_string(u);
-        if (scale==0) { if(neg) s.insert(s.begin(), '-'); return s; }
-        if (s.size() <= (size_t)scale) s.insert(s.begin(), size_t(scale+1 - s.size()), '0');
-        size_t dot = s.size() - (size_t)scale; s.insert(s.begin()+std::ptrdiff_t(dot), '.');
-        while (!s.empty() && s.back()=='0') s.pop_back();
-        if (!s.empty() && s.back()=='.') s.pop_back();
-        if (s.empty()) s="0";
-        if (neg) s.insert(s.begin(), '-');
-        return s;
-    };
-
-    struct Bal { int64_t v=0; int scale=0; };
-    std::unordered_map<std::string, Bal> bal;
+    // Der absolute Betrag kommt in Minor Units aus dem Sortierschluessel.
+    std::vector<detail::RunningBalance> bal(ibans.size());
 
-    for (size_t i=off; i<rows.size(); ++i)
+    for (size_t i=0; i<count; ++i)
     {
-        auto& row = rows[i];
-        const auto& iban = row[to_index(ExportField::AccountIBAN)].second;
-        const auto& asec = row[to_index(ExportField::Amount)].second;       // absolut
+        auto& row = rows[off + i];
         const bool credit = row[to_index(ExportField::CreditDebit)].second == "1";
         const bool reversal = row[to_index(ExportField::Reversal)].second == "1";
 
         int sign = credit ? +1 : -1;
         if (reversal) { sign = -sign; }
 
-        Bal& b = bal[iban];
-        int sScale = frac(asec);
-        if (sScale > b.scale) { for(int k=0;k<sScale-b.scale;++k) { b.v *= 10; } b.scale = sScale; }
-
-        int64_t delta = parse_scaled(asec, b.scale);
-        b.v += sign * delta;
-
-        row[to_index(ExportField::RunningBalance)].first=row[to_index(ExportField::RunningBalance)].second = fmt_scaled(b.v, b.scale);
-        // optional: mirror .first:
-        // row[to_index(ExportField::RunningBalance)].first = row[to_index(ExportField::RunningBalance)].second;
+        auto& rb = row[to_index(ExportField::RunningBalance)];
+        rb.second = bal[keys[i].iban].add(keys[i].amount, keys[i].exp, sign);
+        rb.first = rb.second;
     }
 
     return true;
 }
 
 
+// Fields that identify a transaction: the default field set of
+// accumulate_hash_row() and fingerprint_row() for rows and tables alike.
+// Keep this the only copy, or the same transaction hashes differently
+// depending on the path that produced it.
+inline constexpr ExportField kHashCoreFields[] = {
+    ExportField::BookingDate,
+    ExportField::Amount,
+    ExportField::CreditDebit,
+    ExportField::Currency,
+    ExportField::CounterpartyIBAN,
+    ExportField::CounterpartyBIC,
+    ExportField::RemittanceLine,
+    ExportField::EndToEndId,
+    ExportField::TxId,
+    ExportField::BankRef,
+    ExportField::AccountIBAN,
+    ExportField::BkTxCd,
+    ExportField::Reversal,
+    ExportField::Primanota,
+    ExportField::DTACode
+};
+
+namespace detail {
+// f is one of fields, or of kHashCoreFields if fields is empty
+inline bool hash_field_selected(std::initializer_list<ExportField> fields, ExportField f)
+{
+    if (fields.size() == 0) return std::find(std::begin(kHashCoreFields), std::end(kHashCoreFields), f) != std::end(kHashCoreFields);
+    return std::find(fields.begin(), fields.end(), f) != fields.end();
+}
+} // namespace detail
+
 inline std::string accumulate_hash_row(const CAMTRow& row, const std::initializer_list<ExportField> fields = {})
 {
-    const std::initializer_list<ExportField> kHashCoreFields
+    std::string sum;
+    sum.reserve(512);
+    const std::size_t n = std::min<std::size_t>(row.size(), static_cast<size_t>(ExportField::Count));
+    for (std::size_t i = 0; i < n; ++i) {
+        const ExportField f = static_cast<ExportField>(i);
+        if (!detail::hash_field_selected(fields, f)) continue;
+        sum.append(std::to_string(i));
+        sum.push_back('=');
+        sum.append(row[i].second);
+        sum.push_back('\x1F');
+    }
+    return sum;
+}
+
+// ---------- ExportTable ----------
+// Columnar alternative to ExportData for large exports: one column per
+// ExportField instead of 33 string pairs per row. Texts live in a block arena
+// and the cells hold 32-bit ids; the low-cardinality columns (account, currency,
+// dates, codes, status, ...) are interned, so a repeated value is stored once.
+// The canonical dates (YYYYMMDD) and the ordinals are kept as integers.
+//
+// Filled by export_entries_table() (or export_entries_csv(..., &table)), or
+// row by row with append(). view() results stay valid while the table lives.
+class ExportTable {
+public:
+    static constexpr std::size_t kColumns = static_cast<std::size_t>(ExportField::Count);
+    static constexpr int kNoNumber = std::numeric_limits<int>::min(); // empty number cell
+
+    ExportTable() { strs_.emplace_back(); } // id 0 = ""
+
+    ExportTable(const ExportTable&) = delete; // interned views point into the arena
+    ExportTable& operator=(const ExportTable&) = delete;
+    ExportTable(ExportTable&&) = default;
+    ExportTable& operator=(ExportTable&&) = default;
+
+    std::size_t size() const { return rows_; }
+    bool empty() const { return rows_ == 0; }
+
+    // column titles of the export (empty if exported without header)
+    const std::vector<std::string>& header() const { return header_; }
+    void set_header(const CAMTRow& h)
+    {
+        header_.clear();
+        for (const auto& c : h) header_.push_back(c.first);
+    }
+
+    // number cells: canonical BookingDate/ValueDate (YYYYMMDD) and both parts
+    // of EntryOrdinal/TransactionOrdinal; everything else is text
+    static constexpr bool is_number(ExportField f, bool canonical)
+    {
+        return f == ExportField::EntryOrdinal || f == ExportField::TransactionOrdinal
+            || (canonical && (f == ExportField::BookingDate || f == ExportField::ValueDate));
+    }
+
+    void reserve(std::size_t rows)
+    {
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            const ExportField f = static_cast<ExportField>(c);
+            if (!is_number(f, false)) first_[c].reserve(rows);
+            if (is_number(f, true)) num_[c].reserve(rows);
+            else second_[c].reserve(rows);
+        }
+    }
+
+    void clear()
+    {
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            first_[c].clear();
+            second_[c].clear();
+            num_[c].clear();
+        }
+        header_.clear();
+        strs_.resize(1);
+        interned_.clear();
+        blocks_.clear();
+        blockUsed_ = blockSize_ = 0;
+        rows_ = 0;
+    }
+
+    // row with ExportField::Count cells, canonical values in .second (as
+    // produced by export_entries_csv); a number cell that is not an integer
+    // is stored as empty, the ordinal columns keep only .second (= .first)
+    void append(const CAMTRow& row)
+    {
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            const ExportField f = static_cast<ExportField>(c);
+            static const std::pair<std::string, std::string> none;
+            const auto& cell = c < row.size() ? row[c] : none;
+            const bool intern = interned(f);
+            std::uint32_t firstId = 0;
+            if (!is_number(f, false)) first_[c].push_back(firstId = add(cell.first, intern));
+            if (is_number(f, true)) {
+                num_[c].push_back(to_number(cell.second));
+            } else {
+                // canonical == display is common: share the id
+                const bool same = !is_number(f, false) && cell.second == cell.first;
+                second_[c].push_back(same ? firstId : add(cell.second, intern));
+            }
+        }
+        ++rows_;
+    }
+
+    // text cell (empty view for number cells)
+    std::string_view view(std::size_t row, ExportField f, bool canonical = false) const
+    {
+        if (is_number(f, canonical)) return std::string_view();
+        const std::size_t c = to_index(f);
+        return strs_[canonical ? second_[c][row] : first_[c][row]];
+    }
+
+    // number cell, kNoNumber if empty or not a number column
+    int number(std::size_t row, ExportField f) const
+    {
+        if (!is_number(f, true)) return kNoNumber;
+        return num_[to_index(f)][row];
+    }
+
+    // any cell as text, as it is in ExportData
+    std::string cell(std::size_t row, ExportField f, bool canonical = false) const
+    {
+        if (!is_number(f, canonical)) return std::string(view(row, f, canonical));
+        const int v = number(row, f);
+        return v == kNoNumber ? std::string() : std::to_string(v);
+    }
+
+    // the row in ExportData form
+    CAMTRow row(std::size_t i) const
+    {
+        CAMTRow r(kColumns);
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            const ExportField f = static_cast<ExportField>(c);
+            r[c].first = cell(i, f, false);
+            r[c].second = cell(i, f, true);
+        }
+        return r;
+    }
+
+    // sets a text cell (display and canonical)
+    void set_text(std::size_t row, ExportField f, std::string_view display, std::string_view canonical)
+    {
+        const std::size_t c = to_index(f);
+        if (is_number(f, false)) return;
+        const bool intern = interned(f);
+        first_[c][row] = add(display, intern);
+        if (!is_number(f, true))
+            second_[c][row] = canonical == display ? first_[c][row] : add(canonical, intern);
+    }
+
+    // puts the rows into the given order (order[i] = old index of new row i)
+    void permute(const std::vector<std::size_t>& order)
+    {
+        auto gather = [&](auto& col) {
+            if (col.empty()) return;
+            std::remove_reference_t<decltype(col)> out;
+            out.reserve(order.size());
+            for (std::size_t i : order) out.push_back(col[i]);
+            col.swap(out);
+        };
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            gather(first_[c]);
+            gather(second_[c]);
+            gather(num_[c]);
+        }
+    }
+
+    // id of a canonical text cell; equal ids mean equal text in interned columns
+    std::uint32_t text_id(std::size_t row, ExportField f) const { return second_[to_index(f)][row]; }
+
+    // approximate heap footprint
+    std::size_t memory_bytes() const
+    {
+        std::size_t n = strs_.capacity() * sizeof(std::string_view) + blocks_.size() * blockSize_;
+        for (std::size_t c = 0; c < kColumns; ++c)
+            n += (first_[c].capacity() + second_[c].capacity()) * sizeof(std::uint32_t)
+               + num_[c].capacity() * sizeof(int);
+        return n + interned_.size() * (sizeof(std::string_view) + sizeof(std::uint32_t) + 2 * sizeof(void*));
+    }
+
+private:
+    // columns with few distinct values
+    static constexpr bool interned(ExportField f)
     {
-        ExportField::BookingDate,
-        ExportField::Amount,
-        ExportField::CreditDebit,
-        ExportField::Currency,
-        ExportField::CounterpartyIBAN,
-        ExportField::CounterpartyBIC,
-        ExportField::RemittanceLine,
-        ExportField::EndToEndId,
-        ExportField::TxId,
-        ExportField::BankRef,
-        ExportField::AccountIBAN,
-        ExportField::BkTxCd,
-        ExportField::Reversal,
-        ExportField::Primanota,
-        ExportField::DTACode
+        switch (f) {
+        case ExportField::BookingDate:
+        case ExportField::ValueDate:
+        case ExportField::CreditDebit:
+        case ExportField::Currency:
+        case ExportField::CounterpartyBIC:
+        case ExportField::AccountIBAN:
+        case ExportField::AccountBIC:
+        case ExportField::BkTxCd:
+        case ExportField::BookingCode:
+        case ExportField::Status:
+        case ExportField::Reversal:
+        case ExportField::ServicerBankName:
+        case ExportField::OpeningBalance:
+        case ExportField::ClosingBalance:
+        case ExportField::DTACode:
+        case ExportField::GVCCode:
+        case ExportField::SWIFTTransactionCode:
+        case ExportField::ChargesAmount:
+        case ExportField::ChargesCurrency:
+        case ExportField::ChargesIncluded:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static int to_number(const std::string& s)
+    {
+        int v = 0;
+        const char* e = s.data() + s.size();
+        auto [p, ec] = std::from_chars(s.data(), e, v);
+        return (ec == std::errc() && p == e && v != kNoNumber) ? v : kNoNumber;
+    }
+
+    std::uint32_t add(std::string_view s, bool intern)
+    {
+        if (s.empty()) return 0;
+        if (intern) {
+            auto it = interned_.find(s);
+            if (it != interned_.end()) return it->second;
+        }
+        const std::string_view stored = store(s);
+        const std::uint32_t id = static_cast<std::uint32_t>(strs_.size());
+        strs_.push_back(stored);
+        if (intern) interned_.emplace(stored, id);
+        return id;
+    }
+
+    // copies s into the arena (blocks never move)
+    std::string_view store(std::string_view s)
+    {
+        if (s.size() > blockSize_ - blockUsed_) {
+            blockSize_ = std::max<std::size_t>(kBlock, s.size());
+            blocks_.emplace_back(new char[blockSize_]);
+            blockUsed_ = 0;
+        }
+        char* p = blocks_.back().get() + blockUsed_;
+        std::memcpy(p, s.data(), s.size());
+        blockUsed_ += s.size();
+        return std::string_view(p, s.size());
+    }
+
+    static constexpr std::size_t kBlock = 256 * 1024;
+
+    std::size_t rows_ = 0;
+    std::vector<std::string> header_;
+    std::array<std::vector<std::uint32_t>, kColumns> first_;  // display text ids
+    std::array<std::vector<std::uint32_t>, kColumns> second_; // canonical text ids
+    std::array<std::vector<int>, kColumns> num_;              // number cells
+
+    std::vector<std::string_view> strs_;                       // id -> text
+    std::unordered_map<std::string_view, std::uint32_t> interned_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::size_t blockUsed_ = 0, blockSize_ = 0;
+};
+
+// Same order and running balance as sortExportData(ExportData&, ...). Sorts
+// the keys and gathers the columns once instead of moving whole rows.
+inline bool sortExportData(ExportTable& t, bool useBookingDate, ThreadPool* pool = nullptr)
+{
+    const ExportField keyDate = useBookingDate ? ExportField::BookingDate : ExportField::ValueDate;
+    auto num = [&](std::size_t i, ExportField f) -> int64_t {
+        const int v = t.number(i, f);
+        return v == ExportTable::kNoNumber ? 0 : v; // like from_chars("") in the row version
     };
-    
+
+    // AccountIBAN is interned: equal text <=> equal id
+    std::unordered_map<std::uint32_t, uint32_t> ibanIds;
+    std::vector<std::string_view> ibans;
+    std::vector<detail::ExportSortKey> keys(t.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        detail::ExportSortKey& k = keys[i];
+        k.date  = num(i, keyDate);
+        k.entry = num(i, ExportField::EntryOrdinal);
+        k.tx    = num(i, ExportField::TransactionOrdinal);
+        k.pos   = i;
+        k.amount = detail::row_amount_minor(t.view(i, ExportField::Amount, true),
+                                            t.view(i, ExportField::Currency, true), k.exp);
+        auto it = ibanIds.emplace(t.text_id(i, ExportField::AccountIBAN), (uint32_t)ibans.size());
+        if (it.second) ibans.push_back(t.view(i, ExportField::AccountIBAN, true));
+        k.iban = it.first->second;
+    }
+    const std::vector<uint32_t> rank = detail::rank_texts(ibans);
+    for (auto& k : keys) k.iban = rank[k.iban];
+
+    parallel_sort(pool, keys.begin(), keys.end(), std::less<detail::ExportSortKey>());
+
+    std::vector<std::size_t> order(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) order[i] = keys[i].pos;
+    t.permute(order);
+
+    // running balance per IBAN
+    std::vector<detail::RunningBalance> bal(ibans.size());
+    for (std::size_t i = 0; i < t.size(); ++i) {
+        const bool credit = t.view(i, ExportField::CreditDebit, true) == "1";
+        const bool reversal = t.view(i, ExportField::Reversal, true) == "1";
+        int sign = credit ? +1 : -1;
+        if (reversal) { sign = -sign; }
+
+        const std::string rb = bal[keys[i].iban].add(keys[i].amount, keys[i].exp, sign);
+        t.set_text(i, ExportField::RunningBalance, rb, rb);
+    }
+    return true;
+}
+
+// accumulate_hash_row() for a row of an ExportTable, without materializing it
+inline std::string accumulate_hash_row(const ExportTable& t, std::size_t row, const std::initializer_list<ExportField> fields = {})
+{
     std::string sum;
     sum.reserve(512);
-    CAMTRow _row=row;
-    normalize_or_accumulate_row(_row, fields.size()==0 ? kHashCoreFields : fields, true, &sum);
+    for (std::size_t i = 0; i < ExportTable::kColumns; ++i) {
+        const ExportField f = static_cast<ExportField>(i);
+        if (!detail::hash_field_selected(fields, f)) continue;
+        sum.append(std::to_string(i));
+        sum.push_back('=');
+        if (ExportTable::is_number(f, true)) sum.append(t.cell(row, f, true));
+        else sum.append(t.view(row, f, true));
+        sum.push_back('\x1F');
+    }
     return sum;
 }
 
-// === Actual export function ===========================================
-inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr, ExportData* vPtr=nullptr, const ExportOptions& opt = {}) {
-	
-    if (osPtr && opt.write_utf8_bom) {
-        const unsigned char bom[3] = {0xEF,0xBB,0xBF};
-        osPtr->write(reinterpret_cast<const char*>(bom), 3);
+// ---------- Balance lookups ----------
+// Built once per statement: the first/last balance of each known type code
+// and the interim balances (ITBD/ITAV) by integer date (YYYYMMDD, as
+// Entry::bookingDateInt). Lookups select the same balance as a linear scan
+// over Statement::balances; dates are compared as text after the integer
+// match, so "2025-03-01" and "2025-03-01T00:00:00" stay different.
+class BalanceIndex {
+public:
+    enum Type : unsigned char { OPBD, PRCD, OPAV, CLBD, CLAV, ITBD, ITAV, FWAV, Other, TypeCount };
+
+    static Type type_of(std::string_view code) {
+        static const char* const names[Other] = {"OPBD", "PRCD", "OPAV", "CLBD", "CLAV", "ITBD", "ITAV", "FWAV"};
+        for (int t = 0; t < Other; ++t)
+            if (code == names[t]) return (Type)t;
+        return Other;
     }
-    const char D = opt.delimiter;
 
-    auto find_first_of = [&](const Statement& st, std::initializer_list<const char*> codes) -> const Balance* {
-        for (const auto& b : st.balances)
-            for (const char* c : codes)
-                if (b.type == c) return &b;
-        return nullptr;
-    };
-    auto find_last_of = [&](const Statement& st, std::initializer_list<const char*> codes) -> const Balance* {
-        const Balance* out = nullptr;
-        for (const auto& b : st.balances)
-            for (const char* c : codes)
-                if (b.type == c) out = &b;
-        return out;
-    };
+    BalanceIndex() = default;
+    explicit BalanceIndex(const std::vector<Balance>& balances) { build(balances); }
+
+    void build(const std::vector<Balance>& balances) {
+        balances_ = &balances;
+        std::fill(std::begin(first_), std::end(first_), kNone);
+        std::fill(std::begin(last_), std::end(last_), kNone);
+        interim_.clear();
+        for (std::uint32_t i = 0; i < balances.size(); ++i) {
+            const Type t = type_of(balances[i].type);
+            if (first_[t] == kNone) first_[t] = i;
+            last_[t] = i;
+            if (t == ITBD || t == ITAV) interim_.push_back({parse_iso_date(balances[i].date), i});
+        }
+        std::sort(interim_.begin(), interim_.end()); // by date, then position
+    }
+
+    // first / last balance with one of the types (not Other), nullptr if none
+    const Balance* first_of(std::initializer_list<Type> types) const {
+        std::uint32_t best = kNone;
+        for (Type t : types) best = std::min(best, first_[t]);
+        return at(best);
+    }
+    const Balance* last_of(std::initializer_list<Type> types) const {
+        std::uint32_t best = kNone;
+        for (Type t : types)
+            if (last_[t] != kNone && (best == kNone || last_[t] > best)) best = last_[t];
+        return at(best);
+    }
+
+    // first ITBD/ITAV dated on the entry's booking or value date
+    const Balance* interim_for(const Entry& e) const {
+        if (interim_.empty()) return nullptr;
+        const int d1 = e.bookingDateInt ? e.bookingDateInt : parse_iso_date(e.bookingDate);
+        const int d2 = e.valueDateInt ? e.valueDateInt : parse_iso_date(e.valueDate);
+        return at(std::min(first_interim(d1, e.bookingDate), first_interim(d2, e.valueDate)));
+    }
+
+private:
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+    const Balance* at(std::uint32_t i) const { return i == kNone ? nullptr : &(*balances_)[i]; }
+
+    std::uint32_t first_interim(int date, const std::string& text) const {
+        if (text.empty()) return kNone;
+        auto it = std::lower_bound(interim_.begin(), interim_.end(), std::make_pair(date, std::uint32_t(0)));
+        for (; it != interim_.end() && it->first == date; ++it)
+            if ((*balances_)[it->second].date == text) return it->second;
+        return kNone;
+    }
+
+    const std::vector<Balance>* balances_ = nullptr;
+    std::uint32_t first_[TypeCount] = {};
+    std::uint32_t last_[TypeCount] = {};
+    std::vector<std::pair<int, std::uint32_t>> interim_;  // (date, position)
+};
+
+// === Actual export function ===========================================
+namespace detail {
+// entries [begin, end) of a statement, exported as one unit
+struct ExportPart {
+    const Statement* st = nullptr;
+    std::size_t begin = 0, end = 0;
+    bool starts = true;             // holds the statement's first row (OpeningBalance)
+    bool ends = true;               // holds its last row (ClosingBalance)
+    std::int64_t runningStart = 0;  // RunningBalance before the first row
+    std::string runCcy;             // RunningBalance currency, empty: from the rows
+};
+
+// the rows of the parts, in order; header row / BOM only if 'header'.
+// Returns the number of rows that passed the filter.
+inline std::size_t export_parts(const ExportPart* parts, std::size_t nParts, CsvWriter* csv, ExportData* vPtr,
+                                ExportTable* tPtr, const ExportOptions& opt, bool header) {
+    std::size_t rowsOut = 0;
+
+    // reused for the canonical remittance lines and the counterparty names
+    std::string normBuf;
+    std::optional<FreetextCache> nameCache;
+    if (opt.name_cache_size) nameCache.emplace(opt.name_cache_size);
+
+    // column projection: unselected columns are neither computed nor written
+    using F = ExportField;
+    auto want = [&](F f) { return opt.columns.test(to_index(f)); };
+    std::vector<std::size_t> cols;
+    for (std::size_t i = 0; i < ExportTable::kColumns; ++i)
+        if (opt.columns.test(i)) cols.push_back(i);
+    const bool wantCounterparty = want(F::CounterpartyName) || want(F::CounterpartyIBAN) || want(F::CounterpartyBIC);
+    const bool wantDta = want(F::Primanota) || want(F::DTACode) || want(F::GVCCode);
+    const bool wantCharges = want(F::ChargesAmount) || want(F::ChargesCurrency) || want(F::ChargesIncluded);
+    static const std::string kEmpty;
+
+    if (header && csv && opt.write_utf8_bom) {
+        csv->write("\xEF\xBB\xBF");
+    }
 
     // number WITHOUT currency; sign may be derived from CdtDbtInd (CRDT=+, DBIT=-)
     auto balance_number_str = [&](const Statement& st, const Balance* bal, bool use_decimal_comma=false) -> std::string {
@@ -597,83 +1311,33 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
         return fmt_amount(a, use_decimal_comma); // KEIN CCY-Suffix
     };
 
-    // Interim per transaction (ITBD/ITAV) based on date (BookingDate or ValueDate)
-    auto interim_for_entry = [&](const Statement& st, const Entry& e) -> const Balance* {
-        const std::string& d1 = e.bookingDate;
-        const std::string& d2 = e.valueDate;
-        for (const auto& b : st.balances) {
-            if (b.type == "ITBD" || b.type == "ITAV") {
-                if ((!d1.empty() && b.date == d1) || (!d2.empty() && b.date == d2))
-                    return &b;
-            }
-        }
-        return nullptr;
-    };
-
-    auto find_balance = [&](const Statement& st, const std::string& code) -> const Balance* {
-        for (const auto& b : st.balances) if (b.type == code) return &b;
-        return nullptr;
-    };
-
     auto isProvided = [](const std::string& s) {
         return !s.empty() && s != "NOTPROVIDED";
     };
         
-    if (opt.include_header) {
-        CAMTRow header = {
-            { "BookingDate",        "" },
-            { "ValueDate",          "" },
-            { "Amount",             "" },
-            { (opt.credit_as_bool ? "IsCredit" : "CreditDebit"), "" },
-            { "Currency",           "" },
-            { "CounterpartyName",   "" }, 
-            { "CounterpartyIBAN",   "" }, 
-            { "CounterpartyBIC",    "" },
-            { "RemittanceLine",     "" },
-            { "RemittanceStructured","" },
-            { "EndToEndId",         "" },
-            { "MandateId",          "" },
-            { "TxId",               "" },
-            { "BankRef",            "" },
-            { "AccountIBAN",        "" },
-            { "AccountBIC",         "" },
-            { "BkTxCd",             "" },
-            { "BookingCode",        "" },
-            { "Status",             "" },
-            { "Reversal",           "" },
-            { "RunningBalance",     "" },
-            { "ServicerBankName",   "" },
-            { "OpeningBalance",     "" },
-            { "ClosingBalance",     "" },
-            { "Primanota",          "" },
-            { "DTACode",            "" },
-            { "GVCCode",            "" },
-            { "SWIFTTransactionCode","" },
-            { "ChargesAmount",      "" },
-            { "ChargesCurrency",    "" },
-            { "ChargesIncluded",    "" },
-            { "EntryOrdinal",       "" },
-            { "TxOrdinal",          "" }
-        };
-
-        if (osPtr) {
-            std::ostream& os = *osPtr;
-            for (size_t i = 0; i < header.size(); ++i) {
-                os << header[i].first; // always write only the original part
-                if (i + 1 < header.size()) {
-                    os << D;
-                }
-            }
-            os << "\n";
+    if (header && opt.include_header) {
+        CAMTRow titleRow(ExportTable::kColumns);
+        for (std::size_t i = 0; i < ExportTable::kColumns; ++i)
+            titleRow[i].first = export_field_name(static_cast<F>(i), opt.credit_as_bool);
+
+        if (csv) {
+            for (std::size_t i : cols)
+                csv->raw_field(titleRow[i].first); // always write only the original part
+            csv->end_row();
         }
         if (vPtr) {
-            vPtr->push_back(header);
+            vPtr->push_back(titleRow);
+        }
+        if (tPtr) {
+            tPtr->set_header(titleRow);
         }
     }
     
-    for (const auto& st : doc.statements) {
-        int64_t runningMinor = 0;
-        std::string runCcy = st.account.currency;
+    for (std::size_t pi = 0; pi < nParts; ++pi) {
+        const ExportPart& part = parts[pi];
+        const Statement& st = *part.st;
+        int64_t runningMinor = part.runningStart;
+        std::string runCcy = part.runCcy;
 
         // Use global balances only once per statement (first/last row)
         /*
@@ -683,16 +1347,19 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
         CLBD = Closing Booked Balance
         CLAV = Closing Available Balance
         */
-        const Balance* globalOpen  = find_first_of(st, {"OPBD","PRCD"});
-        const Balance* globalClose = find_last_of (st, {"CLBD"/*,"CLAV"*/});
+        const BalanceIndex balances(st.balances);
+        const Balance* globalOpen  = balances.first_of({BalanceIndex::OPBD, BalanceIndex::PRCD});
+        const Balance* globalClose = balances.last_of ({BalanceIndex::CLBD/*, BalanceIndex::CLAV*/});
+
+        const std::string openGlobalStr  = want(F::OpeningBalance) ? balance_number_str(st, globalOpen) : std::string();
+        const std::string closeGlobalStr = want(F::ClosingBalance) ? balance_number_str(st, globalClose) : std::string();
 
-        const std::string openGlobalStr  = balance_number_str(st, globalOpen);
-        const std::string closeGlobalStr = balance_number_str(st, globalClose);
+        const std::string& accountIban = !st.account.id.iban.empty() ? st.account.id.iban : st.account.id.other;
 
-        // Determine number of transaction rows to output in this statement
+        // Determine number of transaction rows to output in this part
         size_t totalRows = 0;
-        for (const auto& e : st.entries)
-            totalRows += e.transactions.empty() ? 1 : e.transactions.size();
+        for (std::size_t k = part.begin; k < part.end; ++k)
+            totalRows += st.entries[k].transactions.empty() ? 1 : st.entries[k].transactions.size();
 
         // Sum of fees per transaction (always correct sign, incl. reversal flip)
         auto sum_charges_view = [&](const Entry& e, const EntryTransaction* tx) -> std::pair<CurrencyAmount, bool>
@@ -778,7 +1445,7 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
 
             // 2) Counterparty (with option to prefer ultimate parties)
             std::string cpName, cpIban, cpBic;
-            if (tx)
+            if (tx && wantCounterparty)
             {
                 if (effectiveCredit)
                 {
@@ -827,24 +1494,27 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
             std::string remitS_first, remitS_second;
 
             // Display separator from options
-            const std::string disp_sep = opt.remittance_separator;
+            const std::string& disp_sep = opt.remittance_separator;
             // Canonical separator: ASCII GS (0x1D)
             static constexpr char GS = '\x1D';
 
-            if (tx) {
+            if (tx && want(F::RemittanceLine)) {
+                CAMT_STAT_TIMER(t, opt.stats, Normalize);
                 // --- Unstructured remittance lines ---
                 for (size_t i = 0; i < tx->remittance.unstructured.size(); ++i) {
-                    const std::string& part = tx->remittance.unstructured[i];
+                    const std::string& line = tx->remittance.unstructured[i];
 
                     // Display (.first)
                     if (i) remitU_first += disp_sep;
-                    remitU_first += part;
+                    remitU_first += line;
 
                     // Canonical (.second)
                     if (i) remitU_second.push_back(GS);
-                    remitU_second += normalize_field(ExportField::RemittanceLine, part);
+                    normalize_freetext_to(line, normBuf);
+                    remitU_second += normBuf;
                 }
-
+            }
+            if (tx && want(F::RemittanceStructured)) {
                 // --- Structured remittance: take either creditorRef or additionalInfo ---
                 if (!tx->remittance.structured.empty()) {
                     const auto& sr = tx->remittance.structured.front();
@@ -857,17 +1527,13 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
 
 
             // 4) Codes
-            std::string bk, pBk;
-            if (tx) {
+            std::string bk;
+            const std::string& pBk = tx ? tx->proprietaryBankTxCode.code : kEmpty;
+            if (tx && want(F::BkTxCd)) {
                 if (!tx->bankTxCode.domain.empty() || !tx->bankTxCode.family.empty() || !tx->bankTxCode.subFamily.empty())
                     bk = tx->bankTxCode.domain + ":" + tx->bankTxCode.family + ":" + tx->bankTxCode.subFamily;
-                pBk = tx->proprietaryBankTxCode.code;
             }
 			
-			std::string swiftTxCode;
-			if (!pBk.empty())
-				swiftTxCode = pBk.substr(0, std::min<size_t>(4, pBk.size()));
-
             // 5) Amount: prefer TxAmt, otherwise Entry.Amt
             CurrencyAmount amt = e.amount;
             if (tx && tx->txAmount.has_value()) amt = *tx->txAmount;
@@ -887,15 +1553,13 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
             amt_abs.minor = absMinor;
 
             // 7) Additional fields
-            const std::string servicerName = st.account.servicer.name;
-
             // Primanota
             std::string primanota; 
 
             // DTA_Code & GVC
-            std::string dta_code, gvc;
-            if (tx) {
-                dta_code = !tx->proprietaryBankTxCode.code.empty() ? tx->proprietaryBankTxCode.code : dta_code;
+            std::string gvc;
+            const std::string& dta_code = pBk;
+            if (tx && wantDta) {
                 const std::string& c = dta_code;
                 size_t p = c.find('+');
                 if (p != std::string::npos)
@@ -912,10 +1576,10 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
 			
 			// Fallback via ISO mapping if gvc is empty
 			// Fallback via minimal map: PMNT;RCDT;SubFmly;C|D -> ISO ("058")
-			if (gvc.empty() && tx) {
+			if (gvc.empty() && tx && want(F::GVCCode)) {
+				CAMT_STAT_TIMER(t, opt.stats, Gvc);
 				const char dc = (credit ? 'C' : 'D');
 				gvc = camt::lookup_gvc(
-					camt::get_gvc_map(),
 					tx->bankTxCode.domain,   // PMNT
 					tx->bankTxCode.family,   // RCDT
 					tx->bankTxCode.subFamily,// VCOM / FICT / ATXN
@@ -929,96 +1593,93 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
             std::string openingStr = " ";
             std::string closingStr = " ";
 
-            if (!openGlobalStr.empty()) {
-                if (rowIndex == 0) openingStr = openGlobalStr;
-            } else {
-                if (const Balance* it = interim_for_entry(st, e))
-                    openingStr = balance_number_str(st, it);
+            if (want(F::OpeningBalance)) {
+                if (!openGlobalStr.empty()) {
+                    if (rowIndex == 0 && part.starts) openingStr = openGlobalStr;
+                } else {
+                    if (const Balance* it = balances.interim_for(e))
+                        openingStr = balance_number_str(st, it);
+                }
             }
 
-            if (!closeGlobalStr.empty()) {
-                if (rowIndex + 1 == totalRows) closingStr = closeGlobalStr;
-            } else {
-                if (const Balance* it = interim_for_entry(st, e))
-                    closingStr = balance_number_str(st, it);
+            if (want(F::ClosingBalance)) {
+                if (!closeGlobalStr.empty()) {
+                    if (rowIndex + 1 == totalRows && part.ends) closingStr = closeGlobalStr;
+                } else {
+                    if (const Balance* it = balances.interim_for(e))
+                        closingStr = balance_number_str(st, it);
+                }
             }
 
             CurrencyAmount chargesAmt; 
             bool chargesIncluded = false;
-            if (tx) {
+            if (tx && wantCharges) {
                 std::tie(chargesAmt, chargesIncluded) = sum_charges_view(e, tx);
             }
 
             const bool isCredit = (opt.use_effective_credit ? effectiveCredit : credit);
 
-            const std::string currency = st.account.currency.empty() ? (amt.currency.empty() ? runCcy : amt.currency) : st.account.currency;
-
             //const std::string acctSvcrRef = !e.acctSvcrRef.empty() ? e.acctSvcrRef : (tx ? tx->refs.acctSvcrRef : std::string());
-            const std::string acctSvcrRef = (tx && !tx->refs.acctSvcrRef.empty()) ? tx->refs.acctSvcrRef : e.acctSvcrRef;
-
-            const std::string accountIban = !st.account.id.iban.empty() ? st.account.id.iban : st.account.id.other;
-
-            const std::string reversal = (e.reversal ? "1" : "0");
-
-            const std::string st_chargesIncluded = (chargesIncluded ? "1" : "0");
-
-            const std::string importOrdinalEntry = e.importOrdinal >= 0 ? std::to_string(e.importOrdinal) : "";
+            const std::string& acctSvcrRef = (tx && !tx->refs.acctSvcrRef.empty()) ? tx->refs.acctSvcrRef : e.acctSvcrRef;
 
-            const std::string importOrdinalTx = tx ? std::to_string(tx->importOrdinal) : "";
+            const char* reversal = (e.reversal ? "1" : "0");
 
-            CAMTRow row =
-            {
-                {e.bookingDate, std::to_string(e.bookingDateInt)},
-                {e.valueDate, std::to_string(e.valueDateInt)},
-                {fmt_amount(amt), fmt_amount(amt_abs)},
-                {(opt.credit_as_bool ? (isCredit ? "1" : "0") : (isCredit ? "CRDT" : "DBIT")), credit ? "1" : "0"},
-                {currency, ""},
-                {cpName, ""},
-                {cpIban, ""},
-                {cpBic, ""},
-                {remitU_first, remitU_second},
-                {remitS_first, remitS_second},
-                {tx ? tx->refs.endToEndId : std::string(), ""},
-                {tx ? tx->refs.mandateId : std::string(), ""},
-                {tx ? tx->refs.txId : std::string(), ""},
-                {acctSvcrRef, ""},
-                {accountIban, ""},
-                {st.account.servicer.bic, ""},
-                {bk, ""},
-                {pBk, ""},
-                {e.status, ""}, 
-                {reversal, reversal},
-                {fmt_amount(CurrencyAmount{ runCcy, runningMinor }), fmt_amount(CurrencyAmount{ runCcy, runningMinor })},
-                {servicerName, ""},
-                {openingStr, openingStr},
-                {closingStr, closingStr},
-                {primanota, ""},
-                {dta_code, ""},
-                {gvc, ""},
-                {swiftTxCode, ""},
-                {fmt_amount(chargesAmt), fmt_amount(chargesAmt)},
-                {chargesAmt.currency, ""},
-                {st_chargesIncluded, st_chargesIncluded},
-                {importOrdinalEntry, importOrdinalEntry},
-                {importOrdinalTx, importOrdinalTx}
+            // the selected columns; the others stay empty
+            CAMTRow row(ExportTable::kColumns);
+            auto put = [&](F f, auto&& first, auto&& second) {
+                auto& c = row[to_index(f)];
+                c.first = std::forward<decltype(first)>(first);
+                c.second = std::forward<decltype(second)>(second);
             };
-            
-            if (osPtr) {
-                int cnt_field = 0;
-                std::ostream& os = *osPtr;
-                for (const auto& item : row) {
-                    if (++cnt_field == row.size())
-                    {
-                        os << csv_escape(item.first, D);
-                        os << "\n";
-                    }
-                    else
-                    {
-                        os << csv_escape(item.first, D) << D;
-                    }
-                }
+            if (want(F::BookingDate)) put(F::BookingDate, e.bookingDate, std::to_string(e.bookingDateInt));
+            if (want(F::ValueDate)) put(F::ValueDate, e.valueDate, std::to_string(e.valueDateInt));
+            if (want(F::Amount)) put(F::Amount, fmt_amount(amt), fmt_amount(amt_abs));
+            if (want(F::CreditDebit))
+                put(F::CreditDebit, (opt.credit_as_bool ? (isCredit ? "1" : "0") : (isCredit ? "CRDT" : "DBIT")), credit ? "1" : "0");
+            if (want(F::Currency))
+                put(F::Currency, st.account.currency.empty() ? (amt.currency.empty() ? runCcy : amt.currency) : st.account.currency, "");
+            if (want(F::CounterpartyName)) put(F::CounterpartyName, std::move(cpName), "");
+            if (want(F::CounterpartyIBAN)) put(F::CounterpartyIBAN, std::move(cpIban), "");
+            if (want(F::CounterpartyBIC)) put(F::CounterpartyBIC, std::move(cpBic), "");
+            if (want(F::RemittanceLine)) put(F::RemittanceLine, std::move(remitU_first), std::move(remitU_second));
+            if (want(F::RemittanceStructured)) put(F::RemittanceStructured, std::move(remitS_first), std::move(remitS_second));
+            if (tx && want(F::EndToEndId)) put(F::EndToEndId, tx->refs.endToEndId, "");
+            if (tx && want(F::MandateId)) put(F::MandateId, tx->refs.mandateId, "");
+            if (tx && want(F::TxId)) put(F::TxId, tx->refs.txId, "");
+            if (want(F::BankRef)) put(F::BankRef, acctSvcrRef, "");
+            if (want(F::AccountIBAN)) put(F::AccountIBAN, accountIban, "");
+            if (want(F::AccountBIC)) put(F::AccountBIC, st.account.servicer.bic, "");
+            if (want(F::BkTxCd)) put(F::BkTxCd, std::move(bk), "");
+            if (want(F::BookingCode)) put(F::BookingCode, pBk, "");
+            if (want(F::Status)) put(F::Status, e.status, "");
+            if (want(F::Reversal)) put(F::Reversal, reversal, reversal);
+            if (want(F::RunningBalance)) {
+                std::string rb = fmt_amount(CurrencyAmount{ runCcy, runningMinor });
+                put(F::RunningBalance, rb, std::move(rb));
+            }
+            if (want(F::ServicerBankName)) put(F::ServicerBankName, st.account.servicer.name, "");
+            if (want(F::OpeningBalance)) put(F::OpeningBalance, openingStr, openingStr);
+            if (want(F::ClosingBalance)) put(F::ClosingBalance, closingStr, closingStr);
+            if (want(F::Primanota)) put(F::Primanota, std::move(primanota), "");
+            if (want(F::DTACode)) put(F::DTACode, dta_code, "");
+            if (want(F::GVCCode)) put(F::GVCCode, std::move(gvc), "");
+            if (want(F::SWIFTTransactionCode)) put(F::SWIFTTransactionCode, pBk.substr(0, std::min<size_t>(4, pBk.size())), "");
+            if (want(F::ChargesAmount)) {
+                std::string ch = fmt_amount(chargesAmt);
+                put(F::ChargesAmount, ch, std::move(ch));
+            }
+            if (want(F::ChargesCurrency)) put(F::ChargesCurrency, std::move(chargesAmt.currency), "");
+            if (want(F::ChargesIncluded)) put(F::ChargesIncluded, chargesIncluded ? "1" : "0", chargesIncluded ? "1" : "0");
+            if (want(F::EntryOrdinal) && e.importOrdinal >= 0) {
+                std::string o = std::to_string(e.importOrdinal);
+                put(F::EntryOrdinal, o, std::move(o));
             }
-            if(vPtr)
+            if (tx && want(F::TransactionOrdinal)) {
+                std::string o = std::to_string(tx->importOrdinal);
+                put(F::TransactionOrdinal, o, std::move(o));
+            }
+            
+            if(vPtr || tPtr || opt.row_filter)
             {
                 std::initializer_list<ExportField> norm_fields = {
                     ExportField::Currency,
@@ -1044,14 +1705,32 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
                     ExportField::ChargesCurrency
                 };
 
+                CAMT_STAT_TIMER(t, opt.stats, Normalize);
+                auto& name = row[to_index(ExportField::CounterpartyName)];
+                if (nameCache) name.second = nameCache->normalize(name.first);
                 normalize_or_accumulate_row(row, norm_fields, true);
-                vPtr->push_back(row);
             }
 
+            if (opt.row_filter && !opt.row_filter(row)) {
+                ++rowIndex;
+                return;
+            }
+            CAMT_STAT_ADD(opt.stats, rows, 1);
+            ++rowsOut;
+            if (csv) {
+                CAMT_STAT_TIMER(t, opt.stats, CsvWrite);
+                for (std::size_t i : cols)
+                    csv->field(row[i].first);
+                csv->end_row();
+            }
+            if (tPtr) tPtr->append(row);
+            if (vPtr) vPtr->push_back(std::move(row));
+
             ++rowIndex;
         };
 
-        for (const auto& e : st.entries) {
+        for (std::size_t k = part.begin; k < part.end; ++k) {
+            const Entry& e = st.entries[k];
             if (!e.transactions.empty()) {
                 for (const auto& tx : e.transactions) write_row(e, &tx);
             } else {
@@ -1059,6 +1738,125 @@ inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr,
             }
         }
     }
+    return rowsOut;
+}
+
+// one part per statement, or per entriesPerTask entries with a pool; the
+// RunningBalance start and currency of later parts follow from the earlier
+inline std::vector<ExportPart> export_parts_of(const Document& doc, const ExportOptions& opt) {
+    const std::size_t step = opt.pool && opt.entriesPerTask ? opt.entriesPerTask : (std::size_t)-1;
+    std::vector<ExportPart> parts;
+    for (const auto& st : doc.statements) {
+        std::int64_t running = opt.running_balance_start ? opt.running_balance_start(st) : 0;
+        std::string ccy = !st.account.currency.empty() ? st.account.currency : opt.running_balance_currency;
+        const std::size_t n = st.entries.size();
+        std::size_t b = 0;
+        do {
+            ExportPart p;
+            p.st = &st;
+            p.begin = b;
+            p.end = n - b > step ? b + step : n;
+            p.starts = b == 0 && opt.statement_starts;
+            p.ends = p.end == n && opt.statement_ends;
+            p.runningStart = running;
+            p.runCcy = ccy;
+            b = p.end;
+            if (b < n) {
+                for (std::size_t k = p.begin; k < p.end; ++k) {
+                    const Entry& e = st.entries[k];
+                    running += running_contribution(e);
+                    // the currency the export takes from the first row with one
+                    if (ccy.empty()) {
+                        const EntryTransaction* tx = e.transactions.empty() ? nullptr : &e.transactions.front();
+                        const std::string& c = (tx && tx->txAmount.has_value()) ? tx->txAmount->currency : e.amount.currency;
+                        ccy = !c.empty() ? c : e.amount.currency;
+                    }
+                }
+            }
+            parts.push_back(std::move(p));
+        } while (b < n);
+    }
+    return parts;
+}
+} // namespace detail
+
+// Rows go to any combination of a CSV stream, ExportData and an ExportTable
+// (appended, the table's header is replaced if opt.include_header).
+inline void export_entries_csv(const Document& doc, std::ostream* osPtr=nullptr, ExportData* vPtr=nullptr, const ExportOptions& opt = {},
+                               ExportTable* tPtr=nullptr) {
+    CAMT_STAT_SCOPE(statsScope, opt.stats);
+    CAMT_STAT_TIMER(exportTimer, opt.stats, Export);
+    // buffered output, handed to *osPtr in large blocks (flushed on return)
+    std::optional<CsvWriter> csv;
+    if (osPtr) csv.emplace(*osPtr, opt.delimiter);
+    CsvWriter* out = csv ? &*csv : nullptr;
+
+    std::size_t entries = 0;
+    for (const auto& st : doc.statements) entries += st.entries.size();
+    const std::vector<detail::ExportPart> parts = detail::export_parts_of(doc, opt);
+    if (!opt.pool || entries < opt.parallelMinEntries || parts.size() < 2) {
+        detail::export_parts(parts.data(), parts.size(), out, vPtr, tPtr, opt, true);
+        return;
+    }
+
+    // Parallel: the parts are exported into their own buffers on the pool, a
+    // window of them at a time, and appended in order. row_filter runs here,
+    // on the calling thread, in row order (it may be stateful, e.g. DedupIndex).
+    detail::export_parts(nullptr, 0, out, vPtr, tPtr, opt, true); // header, BOM
+    ExportOptions wo = opt;
+    wo.row_filter = nullptr;
+    wo.stats = nullptr;
+    const bool filter = (bool)opt.row_filter;
+    const bool keepRows = vPtr || tPtr || filter;
+    std::vector<std::size_t> cols;
+    for (std::size_t i = 0; i < ExportTable::kColumns; ++i)
+        if (opt.columns.test(i)) cols.push_back(i);
+
+    struct Chunk {
+        std::string csv;
+        ExportData rows;
+        std::size_t count = 0;
+    };
+    const std::size_t window = 4 * (std::size_t)opt.pool->size();
+    std::vector<Chunk> chunks;
+    for (std::size_t w = 0; w < parts.size(); w += window) {
+        const std::size_t n = std::min(window, parts.size() - w);
+        chunks.assign(n, Chunk());
+        opt.pool->parallel_for(n, 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) {
+                Chunk& c = chunks[i];
+                std::optional<CsvWriter> cw;
+                if (out && !filter)
+                    cw.emplace([&c](const char* data, std::size_t size) { c.csv.append(data, size); return true; },
+                               opt.delimiter, 64 * 1024);
+                c.count = detail::export_parts(&parts[w + i], 1, cw ? &*cw : nullptr, keepRows ? &c.rows : nullptr,
+                                               nullptr, wo, false);
+            }
+        });
+        for (Chunk& c : chunks) {
+            if (!filter) {
+                CAMT_STAT_ADD(opt.stats, rows, c.count);
+                if (out) out->write(c.csv);
+                if (tPtr) for (const auto& row : c.rows) tPtr->append(row);
+                if (vPtr) std::move(c.rows.begin(), c.rows.end(), std::back_inserter(*vPtr));
+                continue;
+            }
+            for (auto& row : c.rows) {
+                if (!opt.row_filter(row)) continue;
+                CAMT_STAT_ADD(opt.stats, rows, 1);
+                if (out) {
+                    for (std::size_t i : cols) out->field(row[i].first);
+                    out->end_row();
+                }
+                if (tPtr) tPtr->append(row);
+                if (vPtr) vPtr->push_back(std::move(row));
+            }
+        }
+    }
+}
+
+inline void export_entries_table(const Document& doc, ExportTable& table, const ExportOptions& opt = {}) {
+    export_entries_csv(doc, nullptr, nullptr, opt, &table);
 }
 
 } // namespace camt
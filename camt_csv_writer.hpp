@@ -0,0 +1,199 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace camt {
+
+// ---------- CSV escaping ----------
+// true if the field must be quoted: it contains the delimiter, '"', CR or LF.
+// Scans 8 bytes per step (SWAR: a zero byte in x ^ pattern marks a match).
+inline bool csv_needs_quotes(std::string_view s, char delimiter) {
+    constexpr std::uint64_t ones  = 0x0101010101010101ull;
+    constexpr std::uint64_t highs = 0x8080808080808080ull;
+    auto has = [&](std::uint64_t x, unsigned char c) {
+        const std::uint64_t v = x ^ (ones * c);
+        return (v - ones) & ~v & highs;
+    };
+    const char* p = s.data();
+    const char* const e = p + s.size();
+    for (; e - p >= 8; p += 8) {
+        std::uint64_t x;
+        std::memcpy(&x, p, 8);
+        if (has(x, (unsigned char)delimiter) | has(x, '"') | has(x, '\n') | has(x, '\r')) return true;
+    }
+    for (; p < e; ++p)
+        if (*p == delimiter || *p == '"' || *p == '\n' || *p == '\r') return true;
+    return false;
+}
+
+// Calls put(data, size) for the escaped field: unchanged, or quoted with
+// inner quotes doubled. One scan for the check, one memchr pass per quote.
+template <class Put>
+inline void csv_escape_to(std::string_view s, char delimiter, Put&& put) {
+    if (!csv_needs_quotes(s, delimiter)) {
+        put(s.data(), s.size());
+        return;
+    }
+    put("\"", 1);
+    const char* p = s.data();
+    const char* const e = p + s.size();
+    while (p < e) {
+        const char* q = static_cast<const char*>(std::memchr(p, '"', (std::size_t)(e - p)));
+        if (!q) {
+            put(p, (std::size_t)(e - p));
+            break;
+        }
+        put(p, (std::size_t)(q + 1 - p)); // up to and including the quote
+        put("\"", 1);
+        p = q + 1;
+    }
+    put("\"", 1);
+}
+
+// ---------- CsvWriter ----------
+// Writes CSV rows into a reusable buffer and hands it to the sink in large
+// blocks (bufferSize bytes, default 256 KiB), so the stream or file sees a
+// few big writes instead of two formatted inserts per cell. Fields are
+// escaped straight into the buffer.
+//
+//   CsvWriter w(std::cout, ';');
+//   w.field("a;b"); w.field("c"); w.end_row();   // "a;b";c\n
+//
+// The destructor flushes; call flush() to see whether the sink failed.
+class CsvWriter {
+public:
+    // receives a block of output, returns false on a write error
+    using Sink = std::function<bool(const char* data, std::size_t size)>;
+
+    explicit CsvWriter(std::ostream& os, char delimiter = ';', std::size_t bufferSize = 256 * 1024)
+        : CsvWriter(ostream_sink(os), delimiter, bufferSize)
+    {
+    }
+
+    explicit CsvWriter(Sink sink, char delimiter = ';', std::size_t bufferSize = 256 * 1024)
+        : sink_(std::move(sink)), delimiter_(delimiter)
+    {
+        buf_.resize(bufferSize < 1024 ? 1024 : bufferSize);
+    }
+
+    ~CsvWriter() { flush(); }
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    static Sink ostream_sink(std::ostream& os)
+    {
+        return [&os](const char* data, std::size_t size) {
+            os.write(data, (std::streamsize)size);
+            return (bool)os;
+        };
+    }
+
+    // POSIX file descriptor (or CRT handle on Windows); not closed by the writer
+    static Sink fd_sink(int fd)
+    {
+        return [fd](const char* data, std::size_t size) {
+            while (size) {
+#ifdef _WIN32
+                const int chunk = size > 0x40000000u ? 0x40000000 : (int)size;
+                const int n = ::_write(fd, data, (unsigned)chunk);
+#else
+                const ssize_t n = ::write(fd, data, size);
+                if (n < 0 && errno == EINTR) continue;
+#endif
+                if (n <= 0) return false;
+                data += n;
+                size -= (std::size_t)n;
+            }
+            return true;
+        };
+    }
+
+    char delimiter() const { return delimiter_; }
+
+    // escaped cell, preceded by the delimiter unless it starts the row
+    void field(std::string_view s)
+    {
+        separate();
+        csv_escape_to(s, delimiter_, [this](const char* p, std::size_t n) { put(p, n); });
+    }
+
+    // cell written as is (header names, numbers)
+    void raw_field(std::string_view s)
+    {
+        separate();
+        put(s.data(), s.size());
+    }
+
+    void end_row()
+    {
+        put("\n", 1);
+        rowStart_ = true;
+    }
+
+    // bytes outside the cell structure (e.g. a BOM)
+    void write(std::string_view s) { put(s.data(), s.size()); }
+
+    // hands the buffered bytes to the sink; false if the sink failed (now or before)
+    bool flush()
+    {
+        if (pos_ && ok_) ok_ = sink_(buf_.data(), pos_);
+        pos_ = 0;
+        return ok_;
+    }
+
+    bool good() const { return ok_; }
+
+private:
+    void separate()
+    {
+        if (!rowStart_) put(&delimiter_, 1);
+        rowStart_ = false;
+    }
+
+    void put(const char* p, std::size_t n)
+    {
+        if (n == 0) return;
+        if (n > buf_.size() - pos_) {
+            flush();
+            if (n >= buf_.size()) { // larger than the buffer: bypass it
+                if (ok_) ok_ = sink_(p, n);
+                return;
+            }
+        }
+        if (n == 1) buf_[pos_] = *p;
+        else std::memcpy(buf_.data() + pos_, p, n);
+        pos_ += n;
+    }
+
+    Sink sink_;
+    std::vector<char> buf_;
+    std::size_t pos_ = 0;
+    char delimiter_;
+    bool rowStart_ = true;
+    bool ok_ = true;
+};
+
+} // namespace camt
@@ -0,0 +1,310 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_fingerprint.hpp"
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace camt {
+
+// ---------- Duplicate-detection index ----------
+// Set of transaction fingerprints (Fingerprint128) that survives across
+// files and runs: an open-addressing hash table (linear probing) whose file
+// image is the table itself, so open() maps it without parsing and a lookup
+// touches one or two cache lines. Every slot also records the partition of
+// the transaction (account key and booking date), which prune_before()
+// uses to drop old history.
+//
+// The file is written in host byte order (checked on open). Changes are
+// kept in memory (for a mapped index in copy-on-write pages) until save(),
+// which replaces the file atomically. Not thread-safe.
+//
+//   DedupIndex idx;
+//   idx.open("seen.camtidx", &err);                        // missing file = empty index
+//   opt.row_filter = idx.export_filter(opt, DedupMode::Suppress);
+//   export_entries_csv(doc, &out, nullptr, opt);           // already seen rows are skipped
+//   idx.save("seen.camtidx", &err);
+enum class DedupMode {
+    Suppress,   // drop rows whose fingerprint is already in the index
+    Flag        // keep them and report them to the callback
+};
+
+class DedupIndex {
+public:
+    struct Slot {
+        std::uint64_t lo = 0, hi = 0;  // fingerprint, 0/0 = empty slot
+        std::uint32_t account = 0;     // account_key() of the AccountIBAN
+        std::int32_t date = 0;         // booking date YYYYMMDD
+    };
+    static_assert(sizeof(Slot) == 24, "file layout");
+
+    explicit DedupIndex(std::size_t initialCapacity = 1024) { reset(initialCapacity); }
+
+    DedupIndex(const DedupIndex&) = delete;
+    DedupIndex& operator=(const DedupIndex&) = delete;
+    DedupIndex(DedupIndex&&) = default;
+    DedupIndex& operator=(DedupIndex&&) = default;
+
+    std::size_t size() const { return count_; }
+    std::size_t capacity() const { return cap_; }
+    bool empty() const { return count_ == 0; }
+
+    // partition key of an account (canonical IBAN, see normalize_field)
+    static std::uint32_t account_key(std::string_view canonicalIban)
+    {
+        const Fingerprint128 f = SipHasher128().update(canonicalIban).finish();
+        return (std::uint32_t)f.lo;
+    }
+
+    bool contains(const Fingerprint128& fp) const
+    {
+        const Fingerprint128 k = key(fp);
+        std::size_t i = (std::size_t)k.lo & (cap_ - 1);
+        for (std::size_t n = 0; n < cap_; ++n, i = (i + 1) & (cap_ - 1)) { // a full table ends the probe too
+            const Slot& s = slots_[i];
+            if (s.lo == k.lo && s.hi == k.hi) return true;
+            if (s.lo == 0 && s.hi == 0) return false;
+        }
+        return false;
+    }
+
+    // true if fp was not in the index yet
+    bool insert(const Fingerprint128& fp, std::uint32_t account = 0, std::int32_t date = 0)
+    {
+        if ((count_ + 1) * 10 > cap_ * 7) rehash(cap_ * 2); // load <= 0.7
+        const Fingerprint128 k = key(fp);
+        for (;;) {
+            std::size_t i = (std::size_t)k.lo & (cap_ - 1);
+            for (std::size_t n = 0; n < cap_; ++n, i = (i + 1) & (cap_ - 1)) {
+                Slot& s = slots_[i];
+                if (s.lo == k.lo && s.hi == k.hi) return false;
+                if (s.lo == 0 && s.hi == 0) {
+                    s.lo = k.lo; s.hi = k.hi; s.account = account; s.date = date;
+                    ++count_;
+                    return true;
+                }
+            }
+            rehash(cap_ * 2); // full although count_ said otherwise; rehash() recounts
+        }
+    }
+
+    // fingerprint and partition of an exported row
+    bool insert_row(const CAMTRow& row, bool* isNew = nullptr)
+    {
+        const bool added = insert(fingerprint_row(row), row_account(row), row_date(row));
+        if (isNew) *isNew = added;
+        return added;
+    }
+
+    // removes the entries booked before 'date' (YYYYMMDD); returns how many
+    std::size_t prune_before(std::int32_t date)
+    {
+        std::vector<Slot> keep;
+        for (std::size_t i = 0; i < cap_; ++i) {
+            const Slot& s = slots_[i];
+            if ((s.lo || s.hi) && s.date >= date) keep.push_back(s);
+        }
+        const std::size_t removed = count_ > keep.size() ? count_ - keep.size() : 0;
+        reset(keep.size() * 2);
+        for (const Slot& s : keep) insert_key(s);
+        return removed;
+    }
+
+    void clear() { reset(1024); }
+
+    // ExportOptions::row_filter for export_entries_csv() with opt: inserts
+    // every row's fingerprint; rows seen before are dropped (Suppress) or
+    // passed to onDuplicate and kept (Flag). The fingerprint needs the
+    // kHashCoreFields columns, so they are switched on in opt (and are then
+    // written as well). The index must outlive the export.
+    std::function<bool(CAMTRow&)> export_filter(ExportOptions& opt, DedupMode mode,
+                                                std::function<void(const CAMTRow&)> onDuplicate = {})
+    {
+        for (ExportField f : kHashCoreFields) opt.columns.set(to_index(f));
+        return [this, mode, onDuplicate](CAMTRow& row) {
+            if (insert_row(row)) return true;
+            if (onDuplicate) onDuplicate(row);
+            return mode == DedupMode::Flag;
+        };
+    }
+
+    // Loads an index file (mapped, no copy). A missing file gives an empty
+    // index if createIfMissing; any other problem is an error.
+    bool open(const std::string& utf8Path, std::string* error = nullptr, bool createIfMissing = true)
+    {
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        std::error_code ec;
+        if (!std::filesystem::exists(p, ec)) {
+            if (createIfMissing && !ec) { clear(); return true; }
+            if (error) *error = std::string("Index file not found: '") + utf8Path + "'";
+            return false;
+        }
+
+        MappedFile m;
+        std::string sysErr;
+        if (!m.open(p, &sysErr)) {
+            if (error) *error = std::string("Open failed for '") + utf8Path + "': " + sysErr;
+            return false;
+        }
+        Header h;
+        const bool sized = m.size() >= sizeof(Header);
+        if (sized) std::memcpy(&h, m.data(), sizeof(h));
+        const bool valid = sized && std::memcmp(h.magic, kMagic, sizeof(h.magic)) == 0
+            && h.byteOrder == kByteOrder && h.version == kVersion && h.slotSize == sizeof(Slot)
+            && h.capacity >= 16 && (h.capacity & (h.capacity - 1)) == 0
+            && h.capacity <= (m.size() - sizeof(Header)) / sizeof(Slot)
+            && h.count <= h.capacity && h.count * 10 <= h.capacity * 7 // save() never writes more (load <= 0.7)
+            && m.size() == sizeof(Header) + h.capacity * sizeof(Slot);
+        if (!valid) {
+            if (error) *error = std::string("Not a valid dedup index: '") + utf8Path + "'";
+            return false;
+        }
+
+        owned_.clear();
+        owned_.shrink_to_fit();
+        map_ = std::move(m);
+        slots_ = reinterpret_cast<Slot*>(map_.data() + sizeof(Header)); // page + 64: aligned
+        cap_ = (std::size_t)h.capacity;
+        count_ = (std::size_t)h.count;
+        return true;
+    }
+
+    // writes the index to utf8Path.tmp and renames it over utf8Path
+    bool save(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        detach(); // the file may be the one we map (and Windows cannot replace a mapped file)
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        std::filesystem::path tmp = p;
+        tmp += ".tmp";
+
+        Header h;
+        std::memcpy(h.magic, kMagic, sizeof(h.magic));
+        h.capacity = cap_;
+        h.count = count_;
+
+        errno = 0;
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (out.is_open()) {
+                out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                out.write(reinterpret_cast<const char*>(slots_), (std::streamsize)(cap_ * sizeof(Slot)));
+                out.flush();
+            }
+            if (!out) {
+                const int e = errno;
+                if (error) {
+                    *error = std::string("Write failed for '") + tmp.u8string() + "': "
+                           + (e ? std::system_category().message(e) : std::string("unknown error"));
+                }
+                std::error_code rmEc;
+                std::filesystem::remove(tmp, rmEc);
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, p, ec);
+        if (ec) {
+            if (error) *error = std::string("Rename failed for '") + utf8Path + "': " + ec.message();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Header {
+        char magic[8] = {};
+        std::uint32_t byteOrder = kByteOrder;
+        std::uint32_t version = kVersion;
+        std::uint32_t slotSize = sizeof(Slot);
+        std::uint32_t reserved0 = 0;
+        std::uint64_t capacity = 0;
+        std::uint64_t count = 0;
+        std::uint64_t reserved[3] = {};
+    };
+    static_assert(sizeof(Header) == 64, "file layout");
+    static constexpr char kMagic[8] = {'C', 'A', 'M', 'T', 'D', 'D', 'X', '1'};
+    static constexpr std::uint32_t kByteOrder = 0x01020304u;
+    static constexpr std::uint32_t kVersion = 1;
+
+    // 0/0 marks an empty slot; the (practically impossible) fingerprint 0/0 is stored as 1/0
+    static Fingerprint128 key(const Fingerprint128& fp)
+    {
+        if (fp.lo == 0 && fp.hi == 0) return Fingerprint128{1, 0};
+        return fp;
+    }
+
+    static std::uint32_t row_account(const CAMTRow& row)
+    {
+        const std::size_t i = to_index(ExportField::AccountIBAN);
+        return i < row.size() ? account_key(row[i].second) : 0;
+    }
+    static std::int32_t row_date(const CAMTRow& row)
+    {
+        const std::size_t i = to_index(ExportField::BookingDate);
+        std::int32_t d = 0;
+        if (i < row.size()) {
+            const std::string& s = row[i].second;
+            std::from_chars(s.data(), s.data() + s.size(), d);
+        }
+        return d;
+    }
+
+    void reset(std::size_t minCapacity)
+    {
+        std::size_t c = 16;
+        while (c < minCapacity) c *= 2;
+        map_.close();
+        owned_.assign(c, Slot());
+        slots_ = owned_.data();
+        cap_ = c;
+        count_ = 0;
+    }
+
+    void insert_key(const Slot& s)
+    {
+        for (std::size_t i = (std::size_t)s.lo & (cap_ - 1);; i = (i + 1) & (cap_ - 1)) {
+            if (slots_[i].lo == 0 && slots_[i].hi == 0) { slots_[i] = s; ++count_; return; }
+        }
+    }
+
+    void rehash(std::size_t newCap)
+    {
+        std::vector<Slot> old(slots_, slots_ + cap_);
+        reset(newCap);
+        for (const Slot& s : old)
+            if (s.lo || s.hi) insert_key(s);
+    }
+
+    // moves a mapped table into owned memory
+    void detach()
+    {
+        if (!map_.is_open()) return;
+        owned_.assign(slots_, slots_ + cap_);
+        slots_ = owned_.data();
+        map_.close();
+    }
+
+    std::vector<Slot> owned_;
+    MappedFile map_;
+    Slot* slots_ = nullptr;  // owned_.data() or inside map_
+    std::size_t cap_ = 0;
+    std::size_t count_ = 0;
+};
+
+} // namespace camt
@@ -0,0 +1,239 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_csv.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace camt {
+
+// ---------- Transaction fingerprints ----------
+// A 128-bit hash over the same canonical text accumulate_hash_row() builds
+// ("index=value\x1F" per field), streamed into the hasher field by field:
+//   fingerprint_row(row) == SipHasher128().update(accumulate_hash_row(row)).finish()
+// so fingerprints and existing hash strings identify the same duplicates.
+
+struct Fingerprint128 {
+    std::uint64_t lo = 0;
+    std::uint64_t hi = 0;
+
+    bool operator==(const Fingerprint128& o) const { return lo == o.lo && hi == o.hi; }
+    bool operator!=(const Fingerprint128& o) const { return !(*this == o); }
+    bool operator<(const Fingerprint128& o) const { return hi != o.hi ? hi < o.hi : lo < o.lo; }
+
+    // 32 lowercase hex digits, hi first
+    std::string hex() const
+    {
+        static const char* digits = "0123456789abcdef";
+        std::string s(32, '0');
+        for (int i = 0; i < 16; ++i) {
+            s[(std::size_t)(15 - i)] = digits[(hi >> (4 * i)) & 0xF];
+            s[(std::size_t)(31 - i)] = digits[(lo >> (4 * i)) & 0xF];
+        }
+        return s;
+    }
+};
+
+// SipHash-2-4 with 128-bit output, fed incrementally. Any class with
+// update(const void*, size_t) and finish() can be passed to the fingerprint
+// functions instead (e.g. a wrapper around XXH3-128).
+class SipHasher128 {
+public:
+    // the default key keeps fingerprints stable across runs and machines
+    explicit SipHasher128(std::uint64_t k0 = 0x0706050403020100ull, std::uint64_t k1 = 0x0f0e0d0c0b0a0908ull)
+    {
+        v0_ = k0 ^ 0x736f6d6570736575ull;
+        v1_ = k1 ^ 0x646f72616e646f6dull ^ 0xee;
+        v2_ = k0 ^ 0x6c7967656e657261ull;
+        v3_ = k1 ^ 0x7465646279746573ull;
+    }
+
+    SipHasher128& update(const void* data, std::size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        len_ += size;
+        while (size && tailLen_) { // complete a pending word
+            tail_ |= (std::uint64_t)*p++ << (8 * tailLen_);
+            --size;
+            if (++tailLen_ == 8) { compress(tail_); tail_ = 0; tailLen_ = 0; }
+        }
+        for (; size >= 8; p += 8, size -= 8) compress(load64(p));
+        for (; size; --size) tail_ |= (std::uint64_t)*p++ << (8 * tailLen_++);
+        return *this;
+    }
+    SipHasher128& update(std::string_view s) { return update(s.data(), s.size()); }
+
+    Fingerprint128 finish() const
+    {
+        SipHasher128 h = *this;
+        const std::uint64_t b = ((std::uint64_t)h.len_ << 56) | h.tail_;
+        h.compress(b);
+        h.v2_ ^= 0xee;
+        h.rounds(4);
+        Fingerprint128 out;
+        out.lo = h.v0_ ^ h.v1_ ^ h.v2_ ^ h.v3_;
+        h.v1_ ^= 0xdd;
+        h.rounds(4);
+        out.hi = h.v0_ ^ h.v1_ ^ h.v2_ ^ h.v3_;
+        return out;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+    static std::uint64_t load64(const unsigned char* p)
+    {
+        std::uint64_t v = 0;
+        for (int i = 7; i >= 0; --i) v = (v << 8) | p[i]; // little endian on every host
+        return v;
+    }
+    void rounds(int n)
+    {
+        for (int i = 0; i < n; ++i) {
+            v0_ += v1_; v1_ = rotl(v1_, 13); v1_ ^= v0_; v0_ = rotl(v0_, 32);
+            v2_ += v3_; v3_ = rotl(v3_, 16); v3_ ^= v2_;
+            v0_ += v3_; v3_ = rotl(v3_, 21); v3_ ^= v0_;
+            v2_ += v1_; v1_ = rotl(v1_, 17); v1_ ^= v2_; v2_ = rotl(v2_, 32);
+        }
+    }
+    void compress(std::uint64_t m)
+    {
+        v3_ ^= m;
+        rounds(2);
+        v0_ ^= m;
+    }
+
+    std::uint64_t v0_, v1_, v2_, v3_;
+    std::uint64_t tail_ = 0;
+    unsigned tailLen_ = 0;
+    std::size_t len_ = 0;
+};
+
+namespace detail {
+// "index=value\x1F"
+template <class Hasher>
+inline void fingerprint_item(Hasher& h, ExportField f, std::string_view value)
+{
+    char num[8];
+    const char* e = std::to_chars(num, num + sizeof(num), to_index(f)).ptr;
+    h.update(num, (std::size_t)(e - num));
+    h.update("=", 1);
+    h.update(value.data(), value.size());
+    h.update("\x1F", 1);
+}
+} // namespace detail
+
+// fingerprint of an exported row (canonical values in .second); fields as
+// in accumulate_hash_row(), empty = the default core fields
+template <class Hasher = SipHasher128>
+inline auto fingerprint_row(const CAMTRow& row, std::initializer_list<ExportField> fields = {}, Hasher h = Hasher())
+{
+    const std::size_t n = std::min<std::size_t>(row.size(), ExportTable::kColumns);
+    for (std::size_t i = 0; i < n; ++i) {
+        const ExportField f = static_cast<ExportField>(i);
+        if (detail::hash_field_selected(fields, f)) detail::fingerprint_item(h, f, row[i].second);
+    }
+    return h.finish();
+}
+
+template <class Hasher = SipHasher128>
+inline auto fingerprint_row(const ExportTable& t, std::size_t row, std::initializer_list<ExportField> fields = {}, Hasher h = Hasher())
+{
+    for (std::size_t i = 0; i < ExportTable::kColumns; ++i) {
+        const ExportField f = static_cast<ExportField>(i);
+        if (!detail::hash_field_selected(fields, f)) continue;
+        if (ExportTable::is_number(f, true)) detail::fingerprint_item(h, f, t.cell(row, f, true));
+        else detail::fingerprint_item(h, f, t.view(row, f, true));
+    }
+    return h.finish();
+}
+
+// Fingerprint of the row export_entries_csv() would write for (st, e, tx),
+// computed from the model without building the row; tx == nullptr for an
+// entry without TxDtls. Covers the default core fields and equals
+// fingerprint_row() of that row. One exception: when neither the account,
+// the transaction nor the entry has a currency, the export falls back to
+// the statement's running currency, while this uses "".
+template <class Hasher = SipHasher128>
+inline auto fingerprint_transaction(const Statement& st, const Entry& e, const EntryTransaction* tx, Hasher h = Hasher())
+{
+    const bool credit = (tx && tx->hasCdtDbtInd) ? tx->isCredit : e.isCredit;
+    const bool effectiveCredit = e.reversal ? !credit : credit;
+
+    CurrencyAmount amt = (tx && tx->txAmount.has_value()) ? *tx->txAmount : e.amount;
+    amt.minor = amt.minor < 0 ? -amt.minor : amt.minor;
+
+    const std::string& ccy = !st.account.currency.empty() ? st.account.currency
+                           : (!amt.currency.empty() ? amt.currency : e.amount.currency);
+
+    std::string remit;
+    if (tx) {
+        const auto& lines = tx->remittance.unstructured;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            if (i) remit.push_back('\x1D');
+            remit += normalize_field(ExportField::RemittanceLine, lines[i]);
+        }
+    }
+
+    std::string bk;
+    if (tx && (!tx->bankTxCode.domain.empty() || !tx->bankTxCode.family.empty() || !tx->bankTxCode.subFamily.empty()))
+        bk = tx->bankTxCode.domain + ":" + tx->bankTxCode.family + ":" + tx->bankTxCode.subFamily;
+
+    // DTA code "NMSC+201+999": Primanota is the part after the second '+'
+    const std::string_view dta = tx ? std::string_view(tx->proprietaryBankTxCode.code) : std::string_view();
+    std::string_view primanota;
+    const std::size_t p1 = dta.find('+');
+    if (p1 != std::string_view::npos) {
+        const std::size_t p2 = dta.find('+', p1 + 1);
+        if (p2 != std::string_view::npos) primanota = dta.substr(p2 + 1);
+    }
+
+    static const std::string none;
+    const std::string& acctSvcrRef = (tx && !tx->refs.acctSvcrRef.empty()) ? tx->refs.acctSvcrRef : e.acctSvcrRef;
+    const std::string& accountIban = !st.account.id.iban.empty() ? st.account.id.iban : st.account.id.other;
+    const std::string& cpIban = !tx ? none : (effectiveCredit ? tx->parties.debtorAccount.iban : tx->parties.creditorAccount.iban);
+    const std::string& cpBic  = !tx ? none : (effectiveCredit ? tx->agents.debtorAgent.bic : tx->agents.creditorAgent.bic);
+
+    using F = ExportField;
+    char date[16];
+    const char* de = std::to_chars(date, date + sizeof(date), e.bookingDateInt).ptr;
+    detail::fingerprint_item(h, F::BookingDate, std::string_view(date, (std::size_t)(de - date)));
+    detail::fingerprint_item(h, F::Amount, fmt_amount(amt));
+    detail::fingerprint_item(h, F::CreditDebit, credit ? "1" : "0");
+    detail::fingerprint_item(h, F::Currency, normalize_field(F::Currency, ccy));
+    detail::fingerprint_item(h, F::CounterpartyIBAN, normalize_field(F::CounterpartyIBAN, cpIban));
+    detail::fingerprint_item(h, F::CounterpartyBIC, normalize_field(F::CounterpartyBIC, cpBic));
+    detail::fingerprint_item(h, F::RemittanceLine, remit);
+    detail::fingerprint_item(h, F::EndToEndId, tx ? normalize_field(F::EndToEndId, tx->refs.endToEndId) : std::string());
+    detail::fingerprint_item(h, F::TxId, tx ? normalize_field(F::TxId, tx->refs.txId) : std::string());
+    detail::fingerprint_item(h, F::BankRef, normalize_field(F::BankRef, acctSvcrRef));
+    detail::fingerprint_item(h, F::AccountIBAN, normalize_field(F::AccountIBAN, accountIban));
+    detail::fingerprint_item(h, F::BkTxCd, normalize_field(F::BkTxCd, bk));
+    detail::fingerprint_item(h, F::Reversal, e.reversal ? "1" : "0");
+    detail::fingerprint_item(h, F::Primanota, normalize_field(F::Primanota, primanota));
+    detail::fingerprint_item(h, F::DTACode, normalize_field(F::DTACode, dta));
+    return h.finish();
+}
+
+} // namespace camt
+
+namespace std {
+template <>
+struct hash<camt::Fingerprint128> {
+    std::size_t operator()(const camt::Fingerprint128& f) const noexcept
+    {
+        return (std::size_t)(f.lo ^ (f.hi * 0x9E3779B97F4A7C15ull));
+    }
+};
+} // namespace std
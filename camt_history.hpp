@@ -0,0 +1,385 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_csv.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace camt {
+
+// ---------- Account histories over many documents ----------
+// AccountHistory combines the rows of many documents (e.g. a month of daily
+// statements) in sortExportData() order: date, account IBAN, EntryOrdinal,
+// TransactionOrdinal, then the order in which the inputs were added. Each
+// input is a source of rows already in that order; merge() is a k-way merge
+// over a heap of the sources' current rows, O(n log k) for k sources. No
+// combined copy of the rows is built and nothing is sorted but a source that
+// is not in order by itself. RunningBalance is recomputed in merged order
+// per IBAN and currency, starting from the opening balance of the first
+// statement in that currency (HistoryOptions::runningFromOpening), and
+// continues across files.
+//
+// For documents, the statements' balances are checked for continuity: per
+// account and currency, in date order, each statement's opening balance
+// (OPBD, else PRCD) must equal the previous statement's closing one (CLBD).
+// balance_gaps() reports where it does not, e.g. a missing daily statement.
+//
+//   camt::AccountHistory hist(exportOpt);
+//   for (const auto& path : files) { parser.parse_file(path, doc); hist.add(doc); }
+//   for (const auto& g : hist.balance_gaps()) { /* report */ }
+//   hist.merge_csv(out);
+//
+// Rows of added documents are exported at add() (with the ordinal, date, IBAN,
+// currency and amount columns always computed) and held until merged; custom
+// HistorySource implementations can produce them on demand instead.
+
+// rows of one input, in merge order
+class HistorySource {
+public:
+    virtual ~HistorySource() = default;
+    // the next row, false at the end
+    virtual bool next(CAMTRow& row) = 0;
+};
+
+// exported rows (no header row), sorted when they are not in order
+class HistoryRows : public HistorySource {
+public:
+    // short rows are padded to all columns, like merge() does for any source
+    explicit HistoryRows(ExportData rows, bool useBookingDate = true) : rows_(std::move(rows))
+    {
+        for (CAMTRow& row : rows_)
+            if (row.size() < ExportTable::kColumns) row.resize(ExportTable::kColumns);
+        // with every row padded, sortExportData() has nothing to reject
+        if (!in_order(rows_, useBookingDate)) sortExportData(rows_, false, useBookingDate);
+    }
+
+    bool next(CAMTRow& row) override
+    {
+        if (pos_ == rows_.size()) {
+            ExportData().swap(rows_);
+            return false;
+        }
+        row = std::move(rows_[pos_++]);
+        return true;
+    }
+
+    static bool in_order(const ExportData& rows, bool useBookingDate);
+
+private:
+    ExportData rows_;
+    std::size_t pos_ = 0;
+};
+
+struct HistoryOptions {
+    bool useBookingDate = true;      // date key: BookingDate, else ValueDate
+    bool runningFromOpening = true;  // RunningBalance starts at the first opening balance, else 0
+};
+
+// a break in the balance chain of an account
+struct HistoryGap {
+    enum Kind {
+        BalanceMismatch,  // opening balance differs from the previous closing balance
+        Unverified        // previous CLBD or this OPBD/PRCD missing
+    };
+    Kind kind = BalanceMismatch;
+    std::string account;            // IBAN (or other id), canonical
+    std::string currency;
+    std::string previousStatement;  // Stmt/Id
+    std::string statement;
+    std::string previousDate;       // date of the previous CLBD
+    std::string date;               // date of this OPBD/PRCD
+    std::int64_t expected = 0;      // previous CLBD, signed minor units
+    std::int64_t actual = 0;        // this OPBD/PRCD
+};
+
+namespace detail {
+// merge key of a row, as in sortExportData()
+struct HistoryKey {
+    std::int64_t date = 0;
+    std::string_view iban;
+    std::int64_t entry = 0;
+    std::int64_t tx = 0;
+    std::int64_t amount = 0;  // minor units at exponent 'exp', not part of the order
+    int exp = 0;
+
+    bool operator<(const HistoryKey& o) const
+    {
+        if (date != o.date) return date < o.date;
+        if (iban != o.iban) return iban < o.iban;
+        if (entry != o.entry) return entry < o.entry;
+        return tx < o.tx;
+    }
+};
+
+inline HistoryKey history_key(const CAMTRow& row, bool useBookingDate)
+{
+    auto to_i64 = [](const std::string& s) {
+        std::int64_t v = 0;
+        std::from_chars(s.data(), s.data() + s.size(), v);
+        return v;
+    };
+    HistoryKey k;
+    k.date = to_i64(row[to_index(useBookingDate ? ExportField::BookingDate : ExportField::ValueDate)].second);
+    k.iban = row[to_index(ExportField::AccountIBAN)].second;
+    k.entry = to_i64(row[to_index(ExportField::EntryOrdinal)].second);
+    k.tx = to_i64(row[to_index(ExportField::TransactionOrdinal)].second);
+    k.amount = row_amount_minor(row[to_index(ExportField::Amount)].second, row[to_index(ExportField::Currency)].second, k.exp);
+    return k;
+}
+
+// signed minor units of a balance, as in the export
+inline std::int64_t signed_balance(const Balance& b)
+{
+    const std::int64_t abs = b.amount.minor < 0 ? -b.amount.minor : b.amount.minor;
+    return !b.hasCdtDbtInd ? b.amount.minor : (b.isCredit ? abs : -abs);
+}
+} // namespace detail
+
+inline bool HistoryRows::in_order(const ExportData& rows, bool useBookingDate)
+{
+    for (std::size_t i = 1; i < rows.size(); ++i)
+        if (detail::history_key(rows[i], useBookingDate) < detail::history_key(rows[i - 1], useBookingDate)) return false;
+    return true;
+}
+
+class AccountHistory {
+public:
+    explicit AccountHistory(const ExportOptions& opt = {}, const HistoryOptions& ho = {}) : opt_(opt), ho_(ho) {}
+
+    AccountHistory(const AccountHistory&) = delete;
+    AccountHistory& operator=(const AccountHistory&) = delete;
+
+    // exports the rows of doc and records its statements' balances
+    void add(const Document& doc)
+    {
+        ExportOptions o = opt_;
+        o.include_header = false;
+        o.write_utf8_bom = false;
+        for (ExportField f : {ExportField::BookingDate, ExportField::ValueDate, ExportField::Amount,
+                              ExportField::CreditDebit, ExportField::Reversal, ExportField::AccountIBAN,
+                              ExportField::Currency, ExportField::EntryOrdinal, ExportField::TransactionOrdinal})
+            o.columns.set(to_index(f));
+        ExportData rows;
+        export_entries_csv(doc, nullptr, &rows, o);
+        add(std::make_unique<HistoryRows>(std::move(rows), ho_.useBookingDate));
+
+        for (const auto& st : doc.statements) {
+            StatementBalances s;
+            s.account = normalize_field(ExportField::AccountIBAN,
+                                        !st.account.id.iban.empty() ? st.account.id.iban : st.account.id.other);
+            s.currency = st.account.currency;
+            s.id = st.id;
+            s.order = statements_.size();
+            const BalanceIndex balances(st.balances);
+            const Balance* opening = balances.first_of({BalanceIndex::OPBD, BalanceIndex::PRCD});
+            const Balance* closing = balances.last_of({BalanceIndex::CLBD});
+            s.hasOpening = opening != nullptr;
+            s.hasClosing = closing != nullptr;
+            if (opening) s.opening = *opening;
+            if (closing) s.closing = *closing;
+            s.start = parse_iso_date(opening ? opening->date : (closing ? closing->date : std::string()));
+            if (!s.start && !st.entries.empty()) s.start = st.entries.front().bookingDateInt;
+            s.end = closing ? parse_iso_date(closing->date) : s.start;
+            statements_.push_back(std::move(s));
+        }
+    }
+
+    // rows of one input (no header row), sorted here if they are not in order
+    void add(ExportData rows) { add(std::make_unique<HistoryRows>(std::move(rows), ho_.useBookingDate)); }
+
+    // any source of rows in merge order
+    void add(std::unique_ptr<HistorySource> source) { sources_.push_back(std::move(source)); }
+
+    std::size_t source_count() const { return sources_.size(); }
+
+    // balance chain breaks of the documents added so far
+    std::vector<HistoryGap> balance_gaps() const
+    {
+        std::vector<HistoryGap> gaps;
+        const std::vector<const StatementBalances*> chain = ordered_statements();
+        for (std::size_t i = 1; i < chain.size(); ++i) {
+            const StatementBalances& prev = *chain[i - 1];
+            const StatementBalances& cur = *chain[i];
+            if (prev.account != cur.account || prev.currency != cur.currency) continue;
+            if (!prev.hasClosing && !cur.hasOpening) continue; // no balances to compare (e.g. camt.054)
+
+            HistoryGap g;
+            g.account = cur.account;
+            g.currency = cur.currency;
+            g.previousStatement = prev.id;
+            g.statement = cur.id;
+            if (prev.hasClosing) {
+                g.previousDate = prev.closing.date;
+                g.expected = detail::signed_balance(prev.closing);
+            }
+            if (cur.hasOpening) {
+                g.date = cur.opening.date;
+                g.actual = detail::signed_balance(cur.opening);
+            }
+            if (!prev.hasClosing || !cur.hasOpening) {
+                g.kind = HistoryGap::Unverified;
+            } else if (g.expected != g.actual) {
+                g.kind = HistoryGap::BalanceMismatch;
+            } else {
+                continue;
+            }
+            gaps.push_back(std::move(g));
+        }
+        return gaps;
+    }
+
+    // Merges all sources into sink (which may move from the row; false stops
+    // the merge) and consumes them. Returns the number of rows delivered.
+    std::size_t merge(const std::function<bool(CAMTRow& row)>& sink)
+    {
+        std::unordered_map<std::string, detail::RunningBalance> running = opening_balances();
+        std::string runningKey;
+
+        const std::size_t k = sources_.size();
+        std::vector<CAMTRow> heads(k);
+        std::vector<detail::HistoryKey> keys(k);
+        std::vector<std::size_t> heap;  // source indices, smallest key on top
+        heap.reserve(k);
+        // min-heap: a before b if a's key is smaller, earlier source on ties
+        auto later = [&](std::size_t a, std::size_t b) {
+            if (keys[b] < keys[a]) return true;
+            if (keys[a] < keys[b]) return false;
+            return a > b;
+        };
+        auto pull = [&](std::size_t s) {
+            if (!sources_[s]->next(heads[s])) return false;
+            if (heads[s].size() < ExportTable::kColumns) heads[s].resize(ExportTable::kColumns);
+            keys[s] = detail::history_key(heads[s], ho_.useBookingDate);
+            return true;
+        };
+        for (std::size_t s = 0; s < k; ++s)
+            if (pull(s)) heap.push_back(s);
+        std::make_heap(heap.begin(), heap.end(), later);
+
+        std::size_t delivered = 0;
+        CAMTRow row;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            const std::size_t s = heap.back();
+            row = std::move(heads[s]);
+            const detail::HistoryKey key = keys[s];
+            if (pull(s)) std::push_heap(heap.begin(), heap.end(), later);
+            else heap.pop_back();
+
+            // running balance per IBAN and currency
+            const bool credit = row[to_index(ExportField::CreditDebit)].second == "1";
+            const bool reversal = row[to_index(ExportField::Reversal)].second == "1";
+            int sign = credit ? +1 : -1;
+            if (reversal) { sign = -sign; }
+            auto& rb = row[to_index(ExportField::RunningBalance)];
+            running_key(runningKey, row[to_index(ExportField::AccountIBAN)].second, row[to_index(ExportField::Currency)].second);
+            rb.second = running[runningKey].add(key.amount, key.exp, sign);
+            rb.first = rb.second;
+
+            ++delivered;
+            if (!sink(row)) break;
+        }
+        sources_.clear();
+        return delivered;
+    }
+
+    // merged rows appended to out
+    std::size_t merge(ExportData& out)
+    {
+        return merge([&out](CAMTRow& row) { out.push_back(std::move(row)); return true; });
+    }
+
+    // merged rows as CSV, with the header, BOM and columns of the ExportOptions
+    bool merge_csv(std::ostream& os)
+    {
+        CsvWriter csv(os, opt_.delimiter);
+        std::vector<std::size_t> cols;
+        for (std::size_t i = 0; i < ExportTable::kColumns; ++i)
+            if (opt_.columns.test(i)) cols.push_back(i);
+        if (opt_.write_utf8_bom) csv.write("\xEF\xBB\xBF");
+        if (opt_.include_header) {
+            for (std::size_t i : cols) csv.raw_field(export_field_name(static_cast<ExportField>(i), opt_.credit_as_bool));
+            csv.end_row();
+        }
+        merge([&](CAMTRow& row) {
+            for (std::size_t i : cols) csv.field(row[i].first);
+            csv.end_row();
+            return true;
+        });
+        return csv.flush() && (bool)os;
+    }
+
+private:
+    struct StatementBalances {
+        std::string account, currency, id;
+        std::size_t order = 0;    // position in add() order
+        int start = 0, end = 0;   // YYYYMMDD of the opening / closing balance
+        bool hasOpening = false, hasClosing = false;
+        Balance opening, closing;  // OPBD/PRCD, CLBD
+    };
+
+    // per account and currency, by dates, then in add() order
+    std::vector<const StatementBalances*> ordered_statements() const
+    {
+        std::vector<const StatementBalances*> v;
+        v.reserve(statements_.size());
+        for (const auto& s : statements_) v.push_back(&s);
+        std::sort(v.begin(), v.end(), [](const StatementBalances* a, const StatementBalances* b) {
+            if (a->account != b->account) return a->account < b->account;
+            if (a->currency != b->currency) return a->currency < b->currency;
+            if (a->start != b->start) return a->start < b->start;
+            if (a->end != b->end) return a->end < b->end;
+            return a->order < b->order;
+        });
+        return v;
+    }
+
+    // "account|currency", the key of a running balance
+    static void running_key(std::string& key, std::string_view account, std::string_view currency)
+    {
+        key.assign(account.data(), account.size()).append(1, '|').append(currency.data(), currency.size());
+    }
+
+    // RunningBalance start per IBAN and currency: opening balance of the
+    // first statement (0 if it has none). The currency is that of the rows'
+    // Currency column: the account's, else the opening balance's.
+    std::unordered_map<std::string, detail::RunningBalance> opening_balances() const
+    {
+        std::unordered_map<std::string, detail::RunningBalance> m;
+        if (!ho_.runningFromOpening) return m;
+        std::string key;
+        for (const StatementBalances* s : ordered_statements()) {
+            const std::string& ccy = !s->currency.empty() ? s->currency : s->opening.amount.currency;
+            running_key(key, s->account, ccy);
+            auto it = m.emplace(key, detail::RunningBalance());
+            if (!it.second || !s->hasOpening) continue;
+            it.first->second.v = detail::signed_balance(s->opening);
+            it.first->second.scale = ccy_exp(ccy);
+        }
+        return m;
+    }
+
+    ExportOptions opt_;
+    HistoryOptions ho_;
+    std::vector<std::unique_ptr<HistorySource>> sources_;
+    std::vector<StatementBalances> statements_;
+};
+
+} // namespace camt
@@ -0,0 +1,278 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_session.hpp"
+#include "camt_fingerprint.hpp"
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace camt {
+
+// ---------- Incremental intraday processing ----------
+// Intraday account reports (camt.052) repeat all earlier entries of the day.
+// IncrementalSession keeps state per account between reports and reduces
+// every report to a delta document: only the entries that are new or whose
+// content changed (e.g. status PDNG -> BOOK), and only the balances that
+// differ from the previous report. Export the delta as usual; with
+// export_options() RunningBalance continues where the last report ended.
+//
+// Entries are matched by NtryRef, else AcctSvcrRef, else by their position
+// (importOrdinal) in the report. Their content is compared by fingerprint
+// (fingerprint_transaction() of every row plus status and value date). A
+// changed entry replaces its earlier amount in the running balance, so after
+// each delta the balance is the sum of the current versions of all entries.
+// A different opening balance (OPBD/PRCD) starts a new day for the account
+// and resets its state. Entries missing from a later report stay in the
+// state; they are not reported as removed.
+//
+//   IncrementalSession inc;
+//   if (!inc.parse_file(path, &err)) { /* ... */ }
+//   export_entries_csv(inc.delta(), &out, nullptr, inc.export_options(opt));
+//
+// Not thread-safe. delta() is valid until the next parse or update().
+struct IncrementalStats {
+    std::size_t added = 0;      // entries not seen before
+    std::size_t changed = 0;    // seen, with a different content
+    std::size_t unchanged = 0;  // repeated as is (not in the delta)
+};
+
+struct IncrementalAccountState {
+    struct Seen {
+        Fingerprint128 content;
+        std::int64_t runningMinor = 0;  // contribution to the running balance
+        std::size_t report = 0;         // last report that contained the entry
+    };
+    std::unordered_map<Fingerprint128, Seen> entries; // by identity
+    std::int64_t runningMinor = 0;      // balance after the last report
+    std::vector<Balance> balances;      // of the last report
+    std::size_t reports = 0;            // reports since the last reset
+
+    // last interim balance (ITBD, else ITAV) of the last report
+    const Balance* interim() const
+    {
+        for (const char* code : {"ITBD", "ITAV"})
+            for (auto it = balances.rbegin(); it != balances.rend(); ++it)
+                if (it->type == code) return &*it;
+        return nullptr;
+    }
+};
+
+namespace detail {
+inline bool same_balance(const Balance& a, const Balance& b)
+{
+    return a.type == b.type && a.date == b.date && a.amount.minor == b.amount.minor
+        && a.amount.currency == b.amount.currency && a.hasCdtDbtInd == b.hasCdtDbtInd
+        && a.isCredit == b.isCredit;
+}
+
+inline const Balance* opening_balance(const std::vector<Balance>& balances)
+{
+    for (const auto& b : balances)
+        if (b.type == "OPBD" || b.type == "PRCD") return &b;
+    return nullptr;
+}
+
+} // namespace detail
+
+class IncrementalSession {
+public:
+    IncrementalSession() = default;
+    explicit IncrementalSession(const ParseOptions& opt) : parser_(opt) {}
+
+    // parse a report and update(); on failure the account state is kept and
+    // delta() is empty
+    bool parse_file(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        if (!parser_.parse_file(utf8Path, error)) return fail();
+        update(parser_.document());
+        return true;
+    }
+
+    bool parse_string(const std::string& xml_utf8, std::string* error = nullptr)
+    {
+        return parse_buffer(xml_utf8.data(), xml_utf8.size(), error);
+    }
+
+    bool parse_buffer(const char* data, std::size_t size, std::string* error = nullptr)
+    {
+        if (!parser_.parse_buffer(data, size, error)) return fail();
+        update(parser_.document());
+        return true;
+    }
+
+    // reduces an already parsed report to delta() and carries the state over
+    const IncrementalStats& update(const Document& report)
+    {
+        stats_ = IncrementalStats();
+        ++reportNo_;
+        delta_.kind = report.kind;
+        delta_.statements.clear();
+        starts_.clear();
+
+        for (const auto& st : report.statements) {
+            IncrementalAccountState& acc = accounts_[account_key(st)];
+
+            const Balance* open = detail::opening_balance(st.balances);
+            const Balance* lastOpen = detail::opening_balance(acc.balances);
+            if (open && lastOpen && !detail::same_balance(*open, *lastOpen)) acc = IncrementalAccountState(); // new day
+
+            Statement out;
+            out.id = st.id;
+            out.creationDateTime = st.creationDateTime;
+            out.account = st.account;
+            out.groupHeader = st.groupHeader;
+            for (const auto& b : st.balances) {
+                bool known = false;
+                for (const auto& old : acc.balances) known = known || detail::same_balance(b, old);
+                if (!known) out.balances.push_back(b);
+            }
+
+            std::int64_t start = acc.runningMinor; // minus the old amounts of changed entries
+            for (const auto& e : st.entries) {
+                IncrementalAccountState::Seen* seen = find_or_add(acc, e);
+                const Fingerprint128 content = content_fingerprint(st, e);
+                const std::int64_t amount = detail::running_contribution(e);
+
+                if (seen->report == 0) {
+                    ++stats_.added;
+                } else if (seen->content != content) {
+                    ++stats_.changed;
+                    start -= seen->runningMinor;
+                    acc.runningMinor -= seen->runningMinor;
+                } else {
+                    ++stats_.unchanged;
+                    seen->report = reportNo_;
+                    continue;
+                }
+                seen->content = content;
+                seen->runningMinor = amount;
+                seen->report = reportNo_;
+                acc.runningMinor += amount;
+                out.entries.push_back(e);
+            }
+
+            acc.balances = st.balances;
+            ++acc.reports;
+            if (!out.entries.empty() || !out.balances.empty()) {
+                delta_.statements.push_back(std::move(out));
+                starts_.push_back(start);
+            }
+        }
+        return stats_;
+    }
+
+    const Document& delta() const { return delta_; }
+    const IncrementalStats& stats() const { return stats_; }
+    const Document& report() const { return parser_.document(); } // last full report
+
+    // RunningBalance start of a delta() statement: the account's balance from
+    // the previous reports (0 for any other statement)
+    std::int64_t running_balance_start(const Statement& st) const
+    {
+        return start_of(delta_.statements.data(), starts_, st);
+    }
+
+    // opt with running_balance_start set for delta(); it holds a copy of the
+    // starts, not the session
+    ExportOptions export_options(ExportOptions opt = {}) const
+    {
+        opt.running_balance_start = [first = delta_.statements.data(), starts = starts_](const Statement& st) {
+            return start_of(first, starts, st);
+        };
+        return opt;
+    }
+
+    // state of a statement's account, nullptr if none of its reports was seen
+    const IncrementalAccountState* account(const Statement& st) const
+    {
+        auto it = accounts_.find(account_key(st));
+        return it != accounts_.end() ? &it->second : nullptr;
+    }
+
+    // canonical account IBAN (or other id) and currency
+    static std::string account_key(const Statement& st)
+    {
+        const std::string& id = !st.account.id.iban.empty() ? st.account.id.iban : st.account.id.other;
+        return normalize_field(ExportField::AccountIBAN, id) + '|' + st.account.currency;
+    }
+
+    // forgets all accounts (e.g. at the end of the day)
+    void reset()
+    {
+        accounts_.clear();
+        delta_.statements.clear();
+        starts_.clear();
+        stats_ = IncrementalStats();
+    }
+
+    void reset(const Statement& st) { accounts_.erase(account_key(st)); }
+
+private:
+    static std::int64_t start_of(const Statement* first, const std::vector<std::int64_t>& starts, const Statement& st)
+    {
+        for (std::size_t i = 0; i < starts.size(); ++i)
+            if (first + i == &st) return starts[i];
+        return 0;
+    }
+
+    static Fingerprint128 identity(char kind, std::string_view key)
+    {
+        return SipHasher128().update(&kind, 1).update(key).finish();
+    }
+
+    // slot of e; a reference repeated within the same report falls back to the position
+    IncrementalAccountState::Seen* find_or_add(IncrementalAccountState& acc, const Entry& e)
+    {
+        const std::string& ref = !e.entryRef.empty() ? e.entryRef : e.acctSvcrRef;
+        if (!ref.empty()) {
+            IncrementalAccountState::Seen& s = acc.entries[identity('R', ref)];
+            if (s.report != reportNo_) return &s;
+        }
+        char num[16];
+        const char* end = std::to_chars(num, num + sizeof(num), e.importOrdinal).ptr;
+        return &acc.entries[identity('O', std::string_view(num, (std::size_t)(end - num)))];
+    }
+
+    static Fingerprint128 content_fingerprint(const Statement& st, const Entry& e)
+    {
+        SipHasher128 h;
+        auto add = [&](const Fingerprint128& f) {
+            h.update(&f.lo, sizeof(f.lo));
+            h.update(&f.hi, sizeof(f.hi));
+        };
+        if (e.transactions.empty()) add(fingerprint_transaction(st, e, nullptr));
+        for (const auto& tx : e.transactions) add(fingerprint_transaction(st, e, &tx));
+        h.update(e.status).update("\x1F", 1);
+        h.update(&e.valueDateInt, sizeof(e.valueDateInt));
+        return h.finish();
+    }
+
+    bool fail()
+    {
+        delta_.kind = DocKind::Unknown;
+        delta_.statements.clear();
+        starts_.clear();
+        stats_ = IncrementalStats();
+        return false;
+    }
+
+    ParserSession parser_;
+    std::unordered_map<std::string, IncrementalAccountState> accounts_;
+    Document delta_;
+    std::vector<std::int64_t> starts_;  // RunningBalance start per delta statement
+    IncrementalStats stats_;
+    std::size_t reportNo_ = 0;
+};
+
+} // namespace camt
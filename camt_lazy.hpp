@@ -0,0 +1,234 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_parser_pugi.hpp"
+#include "mapped_file.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace camt {
+
+// ---------- Lazy transaction details ----------
+// LazyDocument maps a document with only the cheap part of every TxDtls up
+// front: the amounts, dates, CdtDbtInd and references that each ParseSection
+// mode reads, plus the sections passed as 'eager'. It keeps the DOM and a
+// handle to each TxDtls element; transaction() and entry() map the remaining
+// sections (ParseOptions::sections) of a transaction the first time it is
+// asked for. The result replaces the cheap version in document() and is
+// kept, so it is the same as Parser::parse_file() would have produced.
+//
+//   camt::LazyDocument lazy;
+//   if (!lazy.parse_file(path, &err)) { /* ... */ }
+//   const camt::Document& doc = lazy.document();   // refs, amounts, dates
+//   ...
+//   const camt::EntryTransaction& tx = lazy.transaction(s, e, t); // everything
+//
+// ParseOptions::filter applies as with Parser; pool is not used (what is left
+// to map up front is the cheap part). gzip input is inflated into memory, ZIP
+// archives are not supported (ZipArchive::extract() + parse_buffer()).
+// Not thread-safe: transaction() and entry() modify the document. Movable,
+// not copyable; document() stays valid until the next parse.
+class LazyDocument {
+public:
+    explicit LazyDocument(const ParseOptions& opt = {}, unsigned eager = 0)
+        : opt_(opt), eager_(eager) {}
+
+    LazyDocument(LazyDocument&&) = default;
+    LazyDocument& operator=(LazyDocument&&) = default;
+
+    // memory-maps the file (copy-on-write) and parses it in place
+    bool parse_file(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        reset();
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if (!check_input_file(p, utf8Path, error)) {
+            return false;
+        }
+        std::string sysMsg;
+        if (!map_.open(p, &sysMsg)) {
+            if (error) {
+                *error = std::string("Open failed for '") + utf8Path + "': " + sysMsg;
+            }
+            return false;
+        }
+        return load(map_.data(), map_.size(), error);
+    }
+
+    bool parse_string(const std::string& xml_utf8, std::string* error = nullptr)
+    {
+        return parse_buffer(xml_utf8.data(), xml_utf8.size(), error);
+    }
+
+    // the data is copied into the LazyDocument and parsed in place
+    bool parse_buffer(const char* data, std::size_t size, std::string* error = nullptr)
+    {
+        reset();
+        text_.assign(data, data + size);
+        return load(text_.data(), text_.size(), error);
+    }
+
+    // transactions hold the cheap fields unless decoded()
+    const Document& document() const { return doc_; }
+    const ParseOptions& options() const { return opt_; }
+
+    // transaction t of entry e of statement s, fully mapped
+    const EntryTransaction& transaction(std::size_t s, std::size_t e, std::size_t t)
+    {
+        EntryTransaction& tx = doc_.statements[s].entries[e].transactions[t];
+        const std::size_t i = txBase_[entryBase_[s] + e] + t;
+        if (!decoded_[i]) {
+            parse_txdtls(tx_[i], tx, nullptr, opt_.sections);
+            decoded_[i] = 1;
+        }
+        return tx;
+    }
+
+    // entry e of statement s with all its transactions fully mapped
+    const Entry& entry(std::size_t s, std::size_t e)
+    {
+        const Entry& en = doc_.statements[s].entries[e];
+        for (std::size_t t = 0; t < en.transactions.size(); ++t) transaction(s, e, t);
+        return en;
+    }
+
+    // maps everything still missing; document() is then complete
+    const Document& decode_all()
+    {
+        for (std::size_t s = 0; s < doc_.statements.size(); ++s)
+            for (std::size_t e = 0; e < doc_.statements[s].entries.size(); ++e) entry(s, e);
+        return doc_;
+    }
+
+    bool decoded(std::size_t s, std::size_t e, std::size_t t) const
+    {
+        return decoded_[txBase_[entryBase_[s] + e] + t] != 0;
+    }
+
+private:
+    void reset()
+    {
+        doc_ = Document();
+        entryBase_.clear();
+        txBase_.clear();
+        tx_.clear();
+        decoded_.clear();
+        if (dom_) dom_->reset();
+        map_.close();
+        std::vector<char>().swap(text_);
+    }
+
+    bool load(char* data, std::size_t size, std::string* error)
+    {
+        switch (detect_compression(data, size)) {
+        case Compression::Gzip: {
+            std::string xml;
+            if (!gunzip(data, size, xml, error)) return false;
+            text_.assign(xml.begin(), xml.end());
+            map_.close();
+            data = text_.data();
+            size = text_.size();
+            break;
+        }
+        case Compression::Zip:
+            if (error) *error = detail::zip_unsupported_message();
+            return false;
+        case Compression::None:
+            break;
+        }
+
+        if (!dom_) dom_ = std::make_unique<pugi::xml_document>(); // none yet, or moved from
+        pugi::xml_parse_result res = dom_->load_buffer_inplace(data, size, pugi::parse_default | pugi::parse_declaration);
+        if (!res)
+        {
+            if(error)
+            {
+                *error=xmlErr;
+                (*error) += res.description();
+            }
+            return false;
+        }
+        return map(error);
+    }
+
+    // parse_document() with entries mapped as 'eager' sections only, and the
+    // TxDtls nodes recorded in document order
+    bool map(std::string* error)
+    {
+        pugi::xml_node root = dom_->document_element();
+        if (!root) {
+            if (error) *error = "Empty document";
+            return false;
+        }
+        pugi::xml_node payload = find_payload(root);
+        doc_.kind = detect_kind(payload);
+        if (doc_.kind == DocKind::Unknown) {
+            if (error) *error = "Unsupported CAMT root";
+            return false;
+        }
+
+        std::optional<GroupHeader> gh;
+        if (pugi::xml_node g = child_any(payload, "GrpHdr")) parse_group_header(g, gh.emplace());
+
+        const ParseFilter* filter = opt_.filter.empty() ? nullptr : &opt_.filter;
+        const bool entryFilter = filter && filter->filters_entries();
+        const unsigned cheap = opt_.sections & eager_;
+        std::size_t ns = 0;
+        for (pugi::xml_node n = payload.first_child(); n; n = n.next_sibling()) {
+            if (!(isln(n, "Stmt") || isln(n, "Ntfctn") || isln(n, "Rpt"))) continue;
+            Statement& st = reuse_slot(doc_.statements, ns);
+            parse_statement_head(n, gh ? &*gh : nullptr, st, opt_.sections);
+            if (filter && !filter->accepts_account(st.account)) continue; // slot is reused
+            ++ns;
+            entryBase_.push_back(txBase_.size());
+
+            std::size_t ordinal = 0, kept = 0;
+            for (pugi::xml_node c = n.first_child(); c; c = c.next_sibling()) {
+                if (!isln(c, "Ntry")) continue;
+                if (entryFilter && !entry_matches(c, *filter)) { ++ordinal; continue; }
+
+                Entry& e = reuse_slot(st.entries, kept++);
+                parse_entry(c, e, nullptr, cheap);
+                e.importOrdinal = (int)ordinal++;
+                txBase_.push_back(tx_.size());
+                // the same TxDtls, in the same order, as parse_entry()
+                for (pugi::xml_node td = child_any(c, "NtryDtls").first_child(); td; td = td.next_sibling())
+                    if (isln(td, "TxDtls")) tx_.push_back(td);
+            }
+            st.entries.resize(kept);
+        }
+        doc_.statements.resize(ns);
+
+        // nothing left to map if the eager sections already cover the rest
+        const bool complete = (opt_.sections & ~eager_ & ~(unsigned)SectionBalances) == 0;
+        decoded_.assign(tx_.size(), complete ? 1 : 0);
+        return true;
+    }
+
+    ParseOptions opt_;
+    unsigned eager_ = 0;
+    Document doc_;
+    std::vector<std::size_t> entryBase_;      // per statement: index of its first entry in txBase_
+    std::vector<std::size_t> txBase_;         // per entry: index of its first TxDtls in tx_
+    std::vector<pugi::xml_node> tx_;          // TxDtls elements, document order
+    std::vector<char> decoded_;               // per tx_: fully mapped
+
+    MappedFile map_;
+    std::vector<char> text_;                  // parse_buffer() / inflated input
+    std::unique_ptr<pugi::xml_document> dom_;  // allocated by load(), null after a move
+
+    const char* xmlErr="XML file parse error: ";
+};
+
+} // namespace camt
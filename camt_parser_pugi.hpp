@@ -10,12 +10,28 @@
 
 #pragma once
 #include "camt_model.hpp"
+#include "mapped_file.hpp"
+#include "camt_thread_pool.hpp"
+#include "camt_tags.hpp"
+#include "camt_currency.hpp"
+#include "camt_stats.hpp"
+#include "camt_archive.hpp"
 #include <pugixml.hpp>
 #include <unordered_map>
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <cstring>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <istream>
+#include <iterator>
 #include <fstream>
+#include <cerrno>
+#include <system_error>
 #include <filesystem>
 
 namespace camt {
@@ -43,24 +59,39 @@ inline pugi::xml_node child_any(const pugi::xml_node& p, const char* name) {
     return pugi::xml_node();
 }
 
-// depth search (recursive) over all descendants
+// depth search over all descendants (pre-order, first match); to look up
+// several names below the same node use collect_desc(), which walks once
 inline pugi::xml_node desc_any(const pugi::xml_node& p, const char* name) {
-    for (pugi::xml_node c = p.first_child(); c; c = c.next_sibling()) {
-        if (isln(c, name)) return c;
-        pugi::xml_node found = desc_any(c, name);
-        if (found) return found;
-    }
-    return pugi::xml_node();
+    CAMT_STAT_ADD(detail::current_stats(), descFallbacks, 1);
+    pugi::xml_node found;
+    walk_desc(p, [&](const pugi::xml_node& c) {
+        if (!isln(c, name)) return true;
+        found = c;
+        return false;
+    });
+    return found;
 }
 
+// trimmed text of the node (a view into the DOM, valid while the document lives)
+inline std::string_view txt_view(const pugi::xml_node& n) {
+    const char* b = n.text().as_string(); // UTF-8
+    const char* e = b + std::strlen(b);
+    auto sp = [](char ch){ return ch==' ' || ch=='\t' || ch=='\n' || ch=='\r'; };
+    while (b < e && sp(*b)) ++b;
+    while (e > b && sp(e[-1])) --e;
+    return std::string_view(b, (size_t)(e - b));
+}
 inline std::string txt(const pugi::xml_node& n) {
-    std::string s = n.text().as_string(); // UTF-8
-    // trim
-    auto notsp = [](int ch){ return ch!=' ' && ch!='\t' && ch!='\n' && ch!='\r'; };
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), notsp));
-    s.erase(std::find_if(s.rbegin(), s.rend(), notsp).base(), s.end());
-    return s;
+    return std::string(txt_view(n));
 }
+// string field assignment for both models: Document (std::string, keeps the
+// capacity of dst) and DocumentView (std::string_view into the DOM)
+inline void set_str(std::string& dst, std::string_view v) { dst.assign(v.data(), v.size()); }
+inline void set_str(std::string_view& dst, std::string_view v) { dst = v; }
+
+// dst = txt(n); a null node clears dst
+template <class S>
+inline void assign_txt(S& dst, const pugi::xml_node& n) { set_str(dst, txt_view(n)); }
 inline std::string child_text(const pugi::xml_node& p, const char* name) {
     pugi::xml_node n = child_any(p, name);
     return n ? txt(n) : std::string();
@@ -70,346 +101,322 @@ inline std::string desc_text(const pugi::xml_node& p, const char* name) {
     return n ? txt(n) : std::string();
 }
 
-// ISO-4217 exponents (short list)
-inline int ccy_exp(const std::string& ccy){
-    static const std::unordered_map<std::string,int> m{
-        {"JPY",0},{"KRW",0},{"VND",0},
-        {"BHD",3},{"KWD",3},{"OMR",3},{"TND",3},
-        {"CLF",4}
-    };
-    auto it = m.find(ccy);
-    return (it==m.end()) ? 2 : it->second;
-}
-
 // "1.234,56" oder "1234.56" -> Minor Units (robust, exception-free, without __int128)
-inline std::int64_t dec_to_minor(std::string s, int exp){
-    // remove simple ASCII groupings/spaces
-    s.erase(std::remove_if(s.begin(), s.end(), [](unsigned char ch){
+// Works on the view in place: the grouping/space characters are skipped while
+// scanning instead of being erased from a copy, so nothing is allocated.
+// Invalid or overflowing input yields 0, except that a negative amount whose
+// minor units exceed INT64_MAX wraps modulo 2^64.
+constexpr std::int64_t dec_to_minor(std::string_view s, int exp){
+    // simple ASCII groupings/spaces are ignored
+    auto ign = [](unsigned char ch){
         return ch==' '||ch=='\t'||ch=='\r'||ch=='\n'||ch=='\''||ch=='_'||ch==0xA0;
-    }), s.end());
+    };
+    std::size_t b = 0, e = s.size();
+    auto trim = [&]{
+        while (b < e && ign((unsigned char)s[b])) ++b;
+        while (e > b && ign((unsigned char)s[e-1])) --e;
+    };
+    trim();
 
     bool neg = false;
-    if (!s.empty() && s.front()=='(' && s.back()==')') {
+    if (e - b >= 2 && s[b]=='(' && s[e-1]==')') {
         neg = true;
-        s.erase(s.begin()); s.pop_back();
+        ++b; --e; trim();
     }
-    if (!s.empty() && (s.front()=='+' || s.front()=='-')) {
-        if (s.front()=='-') neg = !neg;
-        s.erase(s.begin());
+    if (b < e && (s[b]=='+' || s[b]=='-')) {
+        if (s[b]=='-') neg = !neg;
+        ++b; trim();
     }
 
-    // determine decimal separator
-    size_t lastDot = s.find_last_of('.');
-    size_t lastCom = s.find_last_of(',');
+    // decimal separator: the last '.' or ',' (the other one is grouping)
+    std::size_t pos = std::string_view::npos;
     char dec = 0;
-    if (lastDot != std::string::npos || lastCom != std::string::npos) {
-        if (lastDot == std::string::npos) dec = ',';
-        else if (lastCom == std::string::npos) dec = '.';
-        else dec = (lastDot > lastCom) ? '.' : ',';
+    for (std::size_t i = e; i > b; --i) {
+        if (s[i-1]=='.' || s[i-1]==',') { pos = i-1; dec = s[pos]; break; }
     }
-
-    // splitt
-    std::string intp, frac;
-    if (dec) {
-        size_t pos = s.find_last_of(dec);
-        intp = s.substr(0, pos);
-        frac = s.substr(pos+1);
-    } else {
-        intp = s;
-    }
-
-    // remove any separator other than grouping
-    char other = dec ? (dec=='.' ? ',' : '.') : 0;
-    if (other) {
-        intp.erase(std::remove(intp.begin(), intp.end(), other), intp.end());
-        frac.erase(std::remove(frac.begin(), frac.end(), other), frac.end());
+    const char other = dec ? (dec=='.' ? ',' : '.') : 0;
+    const std::size_t intEnd = dec ? pos : e;
+
+    // integer part: digits and 'other' only, "" counts as 0
+    std::uint64_t ip = 0;
+    bool ipOverflow = false;
+    for (std::size_t i = b; i < intEnd; ++i) {
+        const unsigned char c = (unsigned char)s[i];
+        if (ign(c) || c==(unsigned char)other) continue;
+        const unsigned d = (unsigned)(c - '0');
+        if (d > 9) return 0;
+        if (ip > (std::numeric_limits<std::uint64_t>::max() - d) / 10ull) ipOverflow = true;
+        else ip = ip * 10ull + d;
     }
 
-    // allow digits only
-    auto only_digits = [](const std::string& t)->bool {
-        for (unsigned char c : t) if (c < '0' || c > '9') return false;
-        return true;
-    };
-    if (intp.empty()) intp = "0";
-    if (!only_digits(intp) || !only_digits(frac)) return 0;
-
-    // adjust fraction to exponent (truncate or pad)
+    // fraction: digits only, truncated or zero-padded to exp digits
     if (exp < 0) exp = 0;
-    if ((int)frac.size() > exp) frac.resize((size_t)exp);
-    else if ((int)frac.size() < exp) frac.append((size_t)(exp - (int)frac.size()), '0');
-
-    // safe parsers: t -> uint64
-    auto parse_u64 = [](const std::string& t, std::uint64_t& out)->bool {
-        out = 0;
-        for (unsigned char c : t) {
-            unsigned d = (unsigned)(c - '0');
-            if (d > 9) return false;
-            if (out > (std::numeric_limits<std::uint64_t>::max() - d) / 10ull) return false;
-            out = out * 10ull + d;
+    std::uint64_t fp = 0;
+    int nfrac = 0;
+    if (dec) {
+        for (std::size_t i = pos + 1; i < e; ++i) {
+            const unsigned char c = (unsigned char)s[i];
+            if (ign(c)) continue;
+            const unsigned d = (unsigned)(c - '0');
+            if (d > 9) return 0;
+            if (nfrac < exp) { fp = fp * 10ull + d; ++nfrac; }
         }
-        return true;
-    };
-    std::uint64_t ip=0, fp=0;
-    if (!parse_u64(intp, ip)) return 0;
-    if (!parse_u64(frac, fp)) return 0;
-
-    // ip must fit in int64
-    if (ip > (std::uint64_t)std::numeric_limits<std::int64_t>::max()) return 0;
+    }
+    if (ipOverflow) return 0;
+
+    // 10^exp must fit in int64
+    if (exp > 18) return 0;
+    std::int64_t scale = 1;
+    for (int i = 0; i < exp; ++i) scale *= 10;
+    for (int i = nfrac; i < exp; ++i) fp *= 10ull;
+
+    // ip * scale + fp: the major part must fit in int64 on either sign; a
+    // negative value beyond INT64_MAX minor units wraps (unsigned arithmetic)
+    constexpr std::uint64_t lim = (std::uint64_t)std::numeric_limits<std::int64_t>::max();
+    if (ip > lim / (std::uint64_t)scale) return 0;
+    const std::uint64_t scaled_major = ip * (std::uint64_t)scale;
+    if (!neg) return scaled_major > lim - fp ? 0 : (std::int64_t)(scaled_major + fp);
+    const std::int64_t v = (std::int64_t)(scaled_major + fp);
+    return v > 0 ? -v : v;
+}
 
-    // safely compute pow10(exp)
-    auto pow10_i64 = [](int e, std::int64_t& out)->bool {
-        out = 1;
-        for (int i=0;i<e;i++){
-            if (out > (std::numeric_limits<std::int64_t>::max() / 10)) return false;
-            out *= 10;
-        }
-        return true;
-    };
-    std::int64_t scale;
-    if (!pow10_i64(exp, scale)) return 0;
-
-    // safe multiplication a*b -> res, with overflow check (signed)
-    auto mul_check = [](std::int64_t a, std::int64_t b, std::int64_t& res)->bool {
-        // Handle special cases
-        if (a == 0 || b == 0) { res = 0; return true; }
-        // Check overflow generically
-        if (a > 0) {
-            if (b > 0) { if (a > (std::numeric_limits<std::int64_t>::max() / b)) return false; }
-            else { if (b < (std::numeric_limits<std::int64_t>::min() / a)) return false; }
-        } else {
-            if (b > 0) { if (a < (std::numeric_limits<std::int64_t>::min() / b)) return false; }
-            else { if (a != 0 && b < (std::numeric_limits<std::int64_t>::max() / a)) return false; }
-        }
-        res = a * b;
-        return true;
+// "YYYY-MM-DD..." -> YYYYMMDD (e.g. 20251008), 0 if shorter than 10 chars or
+// not numeric. Fixed-shape fast path; otherwise each field is read like
+// std::stoi would (leading digits), without the temporaries and exceptions.
+inline int parse_iso_date(std::string_view s) {
+    if (s.size() < 10) return 0;
+    auto dg = [&](std::size_t i){ return (unsigned)(s[i] - '0'); };
+    if (dg(0) <= 9 && dg(1) <= 9 && dg(2) <= 9 && dg(3) <= 9 && s[4] == '-'
+        && dg(5) <= 9 && dg(6) <= 9 && s[7] == '-' && dg(8) <= 9 && dg(9) <= 9) {
+        const int y = (int)(dg(0) * 1000 + dg(1) * 100 + dg(2) * 10 + dg(3));
+        const int m = (int)(dg(5) * 10 + dg(6));
+        const int d = (int)(dg(8) * 10 + dg(9));
+        return y * 10000 + m * 100 + d;
+    }
+    auto field = [&](std::size_t at, std::size_t n, int& out) {
+        const char* f = s.data() + at;
+        return std::from_chars(f, f + n, out).ec == std::errc();
     };
+    int y = 0, m = 0, d = 0;
+    if (!field(0, 4, y) || !field(5, 2, m) || !field(8, 2, d)) return 0;
+    return y * 10000 + m * 100 + d;
+}
 
-    std::int64_t ip_s = (std::int64_t)ip;
-    std::int64_t scaled_major;
-    if (!mul_check(ip_s, scale, scaled_major)) return 0;
-
-    // fp always fits in scale (because tailored to exp), and fp <= 10^exp-1
-    if (fp > (std::uint64_t)std::numeric_limits<std::int64_t>::max()) return 0;
-    std::int64_t fp_s = (std::int64_t)fp;
-
-    // combine with overflow checks
-    std::int64_t v;
-    if (neg) {
-        // -(scaled_major + fp_s)
-        if (scaled_major < (std::numeric_limits<std::int64_t>::min() + fp_s)) return 0;
-        v = scaled_major + fp_s;
-        if (v > 0) v = -v; // ensure negative
-    } else {
-        if (scaled_major > (std::numeric_limits<std::int64_t>::max() - fp_s)) return 0;
-        v = scaled_major + fp_s;
-    }
-    return v;
+// ---------- Fill-into mapping ----------
+// The parse_xxx(node, out) overloads overwrite every field of 'out' and reuse
+// its string/vector capacity, so a model that is parsed into repeatedly
+// (ParserSession) stops allocating once it has grown to the input size.
+// A null node yields the default-constructed value. They are templates over
+// the target model: Document (camt_model.hpp) or DocumentView (camt_view.hpp).
+
+// element i of v for overwriting; elements left over from an earlier parse are
+// reused, the caller truncates v to the number of filled elements
+template <class V>
+inline auto& reuse_slot(V& v, std::size_t i) {
+    if (i >= v.size()) v.resize(i + 1);
+    return v[i];
 }
 
+template <class A>
+inline void parse_amount(const pugi::xml_node& amt, A& a){
+    set_str(a.currency, {});
+    for (pugi::xml_attribute at = amt.first_attribute(); at; at = at.next_attribute())
+        if (isln(at,"Ccy")) { set_str(a.currency, at.value()); break; }
+    a.minor = dec_to_minor(txt_view(amt), ccy_exp(a.currency));
+}
 inline CurrencyAmount parse_amount(const pugi::xml_node& amt){
     CurrencyAmount a;
-    for (pugi::xml_attribute at = amt.first_attribute(); at; at = at.next_attribute())
-        if (isln(at,"Ccy")) { a.currency = at.value(); break; }
-    a.minor = dec_to_minor(txt(amt), ccy_exp(a.currency));
+    parse_amount(amt, a);
     return a;
 }
 
+template <class Id>
+inline void parse_account_id(const pugi::xml_node& id, Id& out){
+    assign_txt(out.iban, desc_any(id,"IBAN"));
+    set_str(out.other, {});
+    if (out.iban.empty())
+        assign_txt(out.other, child_any(child_any(id,"Othr"),"Id"));
+}
 inline AccountId parse_account_id(const pugi::xml_node& id){
     AccountId out;
-    pugi::xml_node n = desc_any(id,"IBAN");
-    if (n) out.iban = txt(n);
-    if (out.iban.empty()) {
-        pugi::xml_node o = child_any(id,"Othr");
-        if (o) {
-            pugi::xml_node i = child_any(o,"Id");
-            if (i) out.other = txt(i);
-        }
-    }
+    parse_account_id(id, out);
     return out;
 }
 
+template <class Ag>
+inline void parse_agent(const pugi::xml_node& node, Ag& a){
+    pugi::xml_node fi = child_any(node,"FinInstnId");
+    assign_txt(a.bic, child_any(fi,"BIC"));
+    if (a.bic.empty()) assign_txt(a.bic, child_any(fi,"BICFI"));
+    assign_txt(a.name, child_any(fi,"Nm"));
+}
 inline Agent parse_agent(const pugi::xml_node& node){
     Agent a;
-    pugi::xml_node fi = child_any(node,"FinInstnId");
-    if (fi) {
-        pugi::xml_node b = child_any(fi,"BIC");
-        if (b) a.bic = txt(b);
-        if (a.bic.empty()) {
-            pugi::xml_node bf = child_any(fi,"BICFI");
-            if (bf) a.bic = txt(bf);
-        }
-        pugi::xml_node nm = child_any(fi,"Nm");
-        if (nm) a.name = txt(nm);
-    }
+    parse_agent(node, a);
     return a;
 }
 
+template <class P>
+inline void parse_party(const pugi::xml_node& node, P& p){
+    const auto d = collect_desc(node, {Tag::Nm, Tag::IBAN, Tag::BIC, Tag::BICFI});
+    assign_txt(p.name, d[0]);
+    assign_txt(p.iban, d[1]);
+    assign_txt(p.bic, d[2]);
+    if (p.bic.empty()) assign_txt(p.bic, d[3]);
+}
 inline Party parse_party(const pugi::xml_node& node){
     Party p;
-    pugi::xml_node nm = desc_any(node,"Nm"); if (nm) p.name = txt(nm);
-    pugi::xml_node ib = desc_any(node,"IBAN"); if (ib) p.iban = txt(ib);
-    pugi::xml_node b = desc_any(node,"BIC"); if (b) p.bic = txt(b);
-    if (p.bic.empty()) { pugi::xml_node bf = desc_any(node,"BICFI"); if (bf) p.bic = txt(bf); }
+    parse_party(node, p);
     return p;
 }
 
-inline void parse_remittance(const pugi::xml_node& rmt, RemittanceInformation& out){
+template <class Rmt>
+inline void parse_remittance(const pugi::xml_node& rmt, Rmt& out){
+    std::size_t nu = 0, ns = 0;
     for (pugi::xml_node u = rmt.first_child(); u; u = u.next_sibling()){
-        if (isln(u,"Ustrd")){
-            std::string s = txt(u);
-            if (!s.empty()) out.unstructured.push_back(s);
-        } else if (isln(u,"Strd")){
-            StructuredRemittance sr;
-            pugi::xml_node rtp = desc_any(u,"RefTp");
-            if (rtp){
-                pugi::xml_node cdp = desc_any(rtp,"Cd"); if (cdp) sr.creditorRefType = txt(cdp);
-                if (sr.creditorRefType.empty()) {
-                    pugi::xml_node pr = desc_any(rtp,"Prtry"); if (pr) sr.creditorRefType = txt(pr);
-                }
-            }
-            pugi::xml_node cri = desc_any(u,"CdtrRefInf");
-            if (cri){
-                pugi::xml_node rf = child_any(cri,"Ref"); if (rf) sr.creditorRef = txt(rf);
+        const Tag tag = tag_of(u);
+        if (tag == Tag::Ustrd){
+            const std::string_view s = txt_view(u);
+            if (!s.empty()) set_str(reuse_slot(out.unstructured, nu++), s);
+        } else if (tag == Tag::Strd){
+            auto& sr = reuse_slot(out.structured, ns++);
+            const auto d = collect_desc(u, {Tag::RefTp, Tag::CdtrRefInf});
+            set_str(sr.creditorRefType, {});
+            if (d[0]){
+                const auto cp = collect_desc(d[0], {Tag::Cd, Tag::Prtry});
+                assign_txt(sr.creditorRefType, cp[0]);
+                if (sr.creditorRefType.empty()) assign_txt(sr.creditorRefType, cp[1]);
             }
-            pugi::xml_node add = child_any(u,"AddtlRmtInf"); if (add) sr.additionalInfo = txt(add);
-            out.structured.push_back(sr);
+            assign_txt(sr.creditorRef, child_any(d[1],"Ref"));
+            assign_txt(sr.additionalInfo, child_any(u,"AddtlRmtInf"));
         }
     }
+    out.unstructured.resize(nu);
+    out.structured.resize(ns);
 }
 
-inline void parse_related_parties(const pugi::xml_node& rp, RelatedParties& out){
-    pugi::xml_node n;
-    n = child_any(rp,"Dbtr"); if (n) out.debtor = parse_party(n);
-    n = child_any(rp,"DbtrAcct"); if (n) out.debtorAccount = parse_account_id(child_any(n,"Id"));
-    n = child_any(rp,"UltmtDbtr"); if (n) out.ultimateDebtor = parse_party(n);
-    n = child_any(rp,"Cdtr"); if (n) out.creditor = parse_party(n);
-    n = child_any(rp,"CdtrAcct"); if (n) out.creditorAccount = parse_account_id(child_any(n,"Id"));
-    n = child_any(rp,"UltmtCdtr"); if (n) out.ultimateCreditor = parse_party(n);
+template <class Rp>
+inline void parse_related_parties(const pugi::xml_node& rp, Rp& out){
+    const ChildIndex ci(rp);
+    parse_party(ci[Tag::Dbtr], out.debtor);
+    parse_account_id(child_any(ci[Tag::DbtrAcct],"Id"), out.debtorAccount);
+    parse_party(ci[Tag::UltmtDbtr], out.ultimateDebtor);
+    parse_party(ci[Tag::Cdtr], out.creditor);
+    parse_account_id(child_any(ci[Tag::CdtrAcct],"Id"), out.creditorAccount);
+    parse_party(ci[Tag::UltmtCdtr], out.ultimateCreditor);
 }
 
-inline void parse_related_agents(const pugi::xml_node& ra, RelatedAgents& out){
-    pugi::xml_node n;
-    n = child_any(ra,"DbtrAgt"); if (n) out.debtorAgent   = parse_agent(n);
-    n = child_any(ra,"CdtrAgt"); if (n) out.creditorAgent = parse_agent(n);
+template <class Ra>
+inline void parse_related_agents(const pugi::xml_node& ra, Ra& out){
+    parse_agent(child_any(ra,"DbtrAgt"), out.debtorAgent);
+    parse_agent(child_any(ra,"CdtrAgt"), out.creditorAgent);
 }
 
-inline void parse_bktx(const pugi::xml_node& btc, BankTransactionCode& out){
+template <class Btc>
+inline void parse_bktx(const pugi::xml_node& btc, Btc& out){
     pugi::xml_node d = child_any(btc,"Domn");
-    if (d){
-        pugi::xml_node cd = child_any(d,"Cd"); if (cd) out.domain = txt(cd);
-        pugi::xml_node fm = child_any(d,"Fmly");
-        if (fm){
-            pugi::xml_node c = child_any(fm,"Cd"); if (c) out.family = txt(c);
-            pugi::xml_node s = child_any(fm,"SubFmlyCd"); if (s) out.subFamily = txt(s);
-        }
-    }
+    assign_txt(out.domain, child_any(d,"Cd"));
+    pugi::xml_node fm = child_any(d,"Fmly");
+    assign_txt(out.family, child_any(fm,"Cd"));
+    assign_txt(out.subFamily, child_any(fm,"SubFmlyCd"));
     pugi::xml_node p = child_any(btc,"Prtry");
+    set_str(out.proprietary, {});
     if (p){
-        pugi::xml_node cd = child_any(p,"Cd");
-        if (cd) out.proprietary = txt(cd);
-        if (out.proprietary.empty()) out.proprietary = txt(p);
+        assign_txt(out.proprietary, child_any(p,"Cd"));
+        if (out.proprietary.empty()) assign_txt(out.proprietary, p);
     }
 }
 
-inline void parse_proprietary_bktx(const pugi::xml_node& n, ProprietaryBankTransactionCode& out){
-    pugi::xml_node cd = child_any(n,"Cd"); if (cd) out.code = txt(cd);
-    pugi::xml_node is = child_any(n,"Issr"); if (is) out.issuer = txt(is);
+// only overwrites the parts present in the XML (refines BkTxCd/Prtry)
+template <class Pbc>
+inline void parse_proprietary_bktx(const pugi::xml_node& n, Pbc& out){
+    pugi::xml_node cd = child_any(n,"Cd"); if (cd) assign_txt(out.code, cd);
+    pugi::xml_node is = child_any(n,"Issr"); if (is) assign_txt(out.issuer, is);
 }
 
-inline void parse_charges(const pugi::xml_node& n, Charges& out){
+template <class Ch>
+inline void parse_charges(const pugi::xml_node& n, Ch& out){
     // optional: total amount of fees/taxes
-    if (pugi::xml_node t = child_any(n,"TtlChrgsAndTaxAmt"))
-        out.total = parse_amount(t);
+    parse_amount(child_any(n,"TtlChrgsAndTaxAmt"), out.total);
 
+    std::size_t nr = 0;
     for (pugi::xml_node r = n.first_child(); r; r = r.next_sibling()){
         if (!isln(r,"Rcrd")) continue;
 
-        ChargesRecord rec;
+        auto& rec = reuse_slot(out.records, nr++);
+        const ChildIndex rx(r);
 
-        if (pugi::xml_node a  = child_any(r,"Amt"))
-            rec.amount = parse_amount(a);
+        parse_amount(rx[Tag::Amt], rec.amount);
+        parse_agent(rx[Tag::Agt], rec.agent);
 
-        if (pugi::xml_node ag = child_any(r,"Agt"))
-            rec.agent = parse_agent(ag);
+        pugi::xml_node ci = rx[Tag::CdtDbtInd];
+        rec.hasCdtDbtInd = (bool)ci;
+        rec.isCredit     = ci && txt_view(ci) == "CRDT"; // CRDT=+, DBIT=-
 
-        if (pugi::xml_node ci = child_any(r,"CdtDbtInd")) {
-            const std::string s = txt(ci);
-            rec.hasCdtDbtInd = true;
-            rec.isCredit     = (s == "CRDT"); // CRDT=+, DBIT=-
-        }
-
-        if (pugi::xml_node ii = child_any(r,"ChrgInclInd")) {
-            const std::string s = txt(ii);
-            rec.included = (s == "true" || s == "1");
-        }
-
-        out.records.push_back(std::move(rec));
+        pugi::xml_node ii = rx[Tag::ChrgInclInd];
+        const std::string_view s = txt_view(ii);
+        rec.included = ii && (s == "true" || s == "1");
     }
+    out.records.resize(nr);
 }
 
 // from Tx node, search upwards for the related statement container and read Acct/Ccy
-static inline std::string find_account_ccy_from_tx(const pugi::xml_node& tx) {
+static inline std::string_view find_account_ccy_from_tx(const pugi::xml_node& tx) {
     pugi::xml_node stmt = tx;
     while (stmt && !isln(stmt, "Stmt") && !isln(stmt, "Rpt") && !isln(stmt, "Ntfctn")) {
         stmt = stmt.parent();
     }
 
     if (!stmt) {
-        return std::string{};
+        return std::string_view{};
     }
 
     pugi::xml_node acct = child_any(stmt, "Acct");
     if (!acct) {
-        return std::string{};
+        return std::string_view{};
     }
 
     pugi::xml_node ccy = child_any(acct, "Ccy");
     if (!ccy) {
-        return std::string{};
+        return std::string_view{};
     }
 
-    return txt(ccy);
+    return txt_view(ccy);
 }
 
-// select the first amount in the desired currency from AmtDtls (priority: TxAmt, InstdAmt, CntrValAmt)
-static inline std::optional<CurrencyAmount> pick_amount_in_ccy(const pugi::xml_node& amtDtls,
-    const std::string& accountCcy) {
-    if (!amtDtls) {
-        return std::nullopt;
-    }
+// currency attribute of an amount node
+inline std::string_view amount_ccy(const pugi::xml_node& amt) {
+    for (pugi::xml_attribute at = amt.first_attribute(); at; at = at.next_attribute())
+        if (isln(at,"Ccy")) return at.value();
+    return std::string_view{};
+}
 
-    auto pick_one = [&](const char* tag) -> std::optional<CurrencyAmount> {
-        pugi::xml_node n = child_any(amtDtls, tag);
-        if (!n) {
-            return std::nullopt;
+// select the first amount in the desired currency from AmtDtls (priority: TxAmt, InstdAmt, CntrValAmt);
+// returns the Amt node or a null node
+static inline pugi::xml_node pick_amount_in_ccy(const ChildIndex& amtDtls,
+    std::string_view accountCcy) {
+    auto pick_one = [&](Tag tag) -> pugi::xml_node {
+        pugi::xml_node a = child_any(amtDtls[tag], "Amt");
+        if (a && amount_ccy(a) == accountCcy) {
+            return a;
         }
-        pugi::xml_node a = child_any(n, "Amt");
-        if (!a) {
-            return std::nullopt;
-        }
-        CurrencyAmount ca = parse_amount(a);
-        if (ca.currency == accountCcy) {
-            return ca;
-        }
-        return std::nullopt;
+        return pugi::xml_node();
     };
 
-    if (auto ca = pick_one("TxAmt")) {
-        return ca;
-    }
-    if (auto ca = pick_one("InstdAmt")) {
-        return ca;
+    if (pugi::xml_node a = pick_one(Tag::TxAmt)) {
+        return a;
     }
-    if (auto ca = pick_one("CntrValAmt")) {
-        return ca;
+    if (pugi::xml_node a = pick_one(Tag::InstdAmt)) {
+        return a;
     }
-    return std::nullopt;
+    return pick_one(Tag::CntrValAmt);
 }
 
 // reconstruct effective FX rate from two amounts; detect inverted Src/Trgt
-static inline void reconcile_ccyxchg(FxRateInfo& fx,
-    const CurrencyAmount* aSrc,
-    const CurrencyAmount* aTrg,
+template <class Fx, class A>
+static inline void reconcile_ccyxchg(Fx& fx,
+    const A* aSrc,
+    const A* aTrg,
     double* outEffectiveRate,
     bool* outInverted) {
     const double EPS_REL = 1e-6;
@@ -427,7 +434,7 @@ static inline void reconcile_ccyxchg(FxRateInfo& fx,
         return;
     }
 
-    auto toMajor = [](const CurrencyAmount& ca) -> double {
+    auto toMajor = [](const A& ca) -> double {
         int exp = ccy_exp(ca.currency);
         double denom = 1.0;
         for (int i = 0; i < exp; ++i) {
@@ -465,128 +472,122 @@ static inline void reconcile_ccyxchg(FxRateInfo& fx,
     }
 }
 
-inline EntryTransaction parse_txdtls(const pugi::xml_node& tx) {
-    EntryTransaction t;
+// ---------- Parse sections ----------
+// Parts of the model the mapping can leave out (ParseOptions::sections). A
+// skipped part is cleared as if the XML did not contain it; the amounts,
+// dates, references and the account/statement data are always read.
+enum ParseSection : unsigned {
+    SectionParties    = 1u << 0,  // TxDtls/RltdPties
+    SectionAgents     = 1u << 1,  // TxDtls/RltdAgts
+    SectionRemittance = 1u << 2,  // TxDtls/RmtInf
+    SectionCharges    = 1u << 3,  // TxDtls/Chrgs
+    SectionFx         = 1u << 4,  // AmtDtls InstdAmt/CntrValAmt, CcyXchg, rate
+    SectionCodes      = 1u << 5,  // BkTxCd, PrtryBkTxCd (GVC, DTA code)
+    SectionDetails    = 1u << 6,  // Purp, AddtlTxInf
+    SectionBalances   = 1u << 7,  // Stmt/Bal
+    SectionAll        = 0xFFFFFFFFu
+};
+
+// accountCcyHint: currency of the enclosing statement account; if null it is
+// looked up by walking up from the Tx node (requires the full DOM).
+// importOrdinal is left to the caller.
+template <class T>
+inline void parse_txdtls(const pugi::xml_node& tx, T& t, const std::string_view* accountCcyHint = nullptr,
+                         unsigned sections = SectionAll) {
+    const ChildIndex ci(tx);
+    // child for tag, or a null node (= cleared) if its section is skipped
+    auto part = [&](ParseSection sec, Tag tag) { return (sections & sec) ? ci[tag] : pugi::xml_node(); };
 
     // ----- Refs -----
-    if (pugi::xml_node refs = child_any(tx, "Refs")) {
-        pugi::xml_node n;
-        n = child_any(refs, "EndToEndId");
-        if (n) {
-            t.refs.endToEndId = txt(n);
-        }
-        n = child_any(refs, "TxId");
-        if (n) {
-            t.refs.txId = txt(n);
-        }
-        n = child_any(refs, "AcctSvcrRef");
-        if (n) {
-            t.refs.acctSvcrRef = txt(n);
-        }
-        n = child_any(refs, "MndtId");
-        if (n) {
-            t.refs.mandateId = txt(n);
-        }
-    }
+    const ChildIndex refs(ci[Tag::Refs]);
+    assign_txt(t.refs.endToEndId, refs[Tag::EndToEndId]);
+    assign_txt(t.refs.txId, refs[Tag::TxId]);
+    assign_txt(t.refs.acctSvcrRef, refs[Tag::AcctSvcrRef]);
+    assign_txt(t.refs.mandateId, refs[Tag::MndtId]);
+    set_str(t.refs.msgId, {});
 
     // ----- BankTransactionCode (incl. proprietary/GVC) -----
-    if (pugi::xml_node btc = child_any(tx, "BkTxCd")) {
-        parse_bktx(btc, t.bankTxCode);
+    pugi::xml_node btc = part(SectionCodes, Tag::BkTxCd);
+    parse_bktx(btc, t.bankTxCode);
 
-        if (pugi::xml_node pr = child_any(btc, "Prtry")) {
-            pugi::xml_node cd = child_any(pr, "Cd");
-            if (cd) {
-                t.proprietaryBankTxCode.code = txt(cd);
-            }
-            pugi::xml_node is = child_any(pr, "Issr");
-            if (is) {
-                t.proprietaryBankTxCode.issuer = txt(is);
-            }
-        }
+    pugi::xml_node pr = child_any(btc, "Prtry");
+    assign_txt(t.proprietaryBankTxCode.code, child_any(pr, "Cd"));
+    assign_txt(t.proprietaryBankTxCode.issuer, child_any(pr, "Issr"));
 
-        t.dtaCode = t.proprietaryBankTxCode.code;
+    t.dtaCode = t.proprietaryBankTxCode.code;
 
-        const std::string& c = t.proprietaryBankTxCode.code;
+    {
+        const std::string_view c = t.proprietaryBankTxCode.code;
         size_t p = c.find('+');
-        if (p != std::string::npos && (p + 1) < c.size()) {
-            t.gvc = c.substr(p + 1);
+        if (p != std::string_view::npos && (p + 1) < c.size()) {
+            set_str(t.gvc, c.substr(p + 1));
+        } else {
+            set_str(t.gvc, {});
         }
     }
 
     // ----- Parties/Agents/Remittance information -----
-    if (pugi::xml_node rp = child_any(tx, "RltdPties")) {
-        parse_related_parties(rp, t.parties);
-    }
-    if (pugi::xml_node ra = child_any(tx, "RltdAgts")) {
-        parse_related_agents(ra, t.agents);
-    }
-    if (pugi::xml_node rmt = child_any(tx, "RmtInf")) {
-        parse_remittance(rmt, t.remittance);
-    }
-    if (pugi::xml_node p = child_any(tx, "Purp")) {
-        pugi::xml_node c = child_any(p, "Cd");
-        if (c) {
-            t.purpose.code = txt(c);
-        }
-        pugi::xml_node pr = child_any(p, "Prtry");
-        if (pr) {
-            t.purpose.proprietary = txt(pr);
-        }
-    }
-    if (pugi::xml_node pbc = child_any(tx, "PrtryBkTxCd")) {
+    parse_related_parties(part(SectionParties, Tag::RltdPties), t.parties);
+    parse_related_agents(part(SectionAgents, Tag::RltdAgts), t.agents);
+    parse_remittance(part(SectionRemittance, Tag::RmtInf), t.remittance);
+
+    pugi::xml_node purp = part(SectionDetails, Tag::Purp);
+    assign_txt(t.purpose.code, child_any(purp, "Cd"));
+    assign_txt(t.purpose.proprietary, child_any(purp, "Prtry"));
+
+    if (pugi::xml_node pbc = part(SectionCodes, Tag::PrtryBkTxCd)) {
         parse_proprietary_bktx(pbc, t.proprietaryBankTxCode);
     }
-    if (pugi::xml_node ch = child_any(tx, "Chrgs")) {
-        parse_charges(ch, t.charges);
-    }
-    if (pugi::xml_node ai = child_any(tx, "AddtlTxInf")) {
-        t.additionalInfo = txt(ai);
-    }
+    parse_charges(part(SectionCharges, Tag::Chrgs), t.charges);
+    assign_txt(t.additionalInfo, part(SectionDetails, Tag::AddtlTxInf));
+    set_str(t.codeSwift, {});
 
     // ----- Amount of single transaction (Tx level) -----
-    // primary: TxDtls/Amt
-    if (pugi::xml_node a0 = child_any(tx, "Amt")) {
-        t.txAmount = parse_amount(a0);
+    // primary: TxDtls/Amt, fallback: TxDtls/AmtDtls/TxAmt/Amt
+    pugi::xml_node ad = ci[Tag::AmtDtls];
+    const ChildIndex adx(ad);
+    pugi::xml_node a0 = ci[Tag::Amt];
+    if (!a0) {
+        a0 = child_any(adx[Tag::TxAmt], "Amt");
+    }
+    if (a0) {
+        parse_amount(a0, t.txAmount ? *t.txAmount : t.txAmount.emplace());
     } else {
-        // Fallback: TxDtls/AmtDtls/TxAmt/Amt
-        if (pugi::xml_node ad = child_any(tx, "AmtDtls")) {
-            if (pugi::xml_node ta = child_any(ad, "TxAmt")) {
-                if (pugi::xml_node a = child_any(ta, "Amt")) {
-                    t.txAmount = parse_amount(a);
-                }
-            }
-        }
+        t.txAmount.reset();
     }
 
     // sign indicator (Tx level)
-    if (pugi::xml_node cdi = child_any(tx, "CdtDbtInd")) {
-        t.hasCdtDbtInd = true;
-        t.isCredit = (txt(cdi) == "CRDT");
-    }
+    pugi::xml_node cdi = ci[Tag::CdtDbtInd];
+    t.hasCdtDbtInd = (bool)cdi;
+    t.isCredit = cdi && txt_view(cdi) == "CRDT";
 
     // ----- Foreign currency details (optional) -----
-    if (pugi::xml_node ad = child_any(tx, "AmtDtls")) {
+    set_str(t.fx.srcCcy, {});
+    set_str(t.fx.trgtCcy, {});
+    set_str(t.fx.unitCcy, {});
+    t.fx.rate = 0.0;
+    t.fx.has = false;
+    parse_amount(pugi::xml_node(), t.fxInstdAmt);
+    parse_amount(pugi::xml_node(), t.fxTxAmt);
+    parse_amount(pugi::xml_node(), t.fxCounterValAmt);
+    t.hasFxInstdAmt = false;
+    t.hasFxTxAmt = false;
+    t.hasFxCntrVal = false;
+    const bool fx = (sections & SectionFx) != 0;
+
+    if (ad && fx) {
         // 2.1 InstdAmt
-        if (pugi::xml_node ia = child_any(ad, "InstdAmt")) {
+        if (pugi::xml_node ia = adx[Tag::InstdAmt]) {
             if (pugi::xml_node a = child_any(ia, "Amt")) {
-                t.fxInstdAmt = parse_amount(a);
+                parse_amount(a, t.fxInstdAmt);
                 t.hasFxInstdAmt = true;
 
-                if (pugi::xml_node cx = child_any(ia, "CcyXchg")) {
-                    pugi::xml_node n;
-                    n = child_any(cx, "SrcCcy");
-                    if (n) {
-                        t.fx.srcCcy = txt(n);
-                    }
-                    n = child_any(cx, "TrgtCcy");
-                    if (n) {
-                        t.fx.trgtCcy = txt(n);
-                    }
-                    n = child_any(cx, "UnitCcy");
-                    if (n) {
-                        t.fx.unitCcy = txt(n);
-                    }
-                    n = child_any(cx, "XchgRate");
+                if (pugi::xml_node cxn = child_any(ia, "CcyXchg")) {
+                    const ChildIndex cx(cxn);
+                    assign_txt(t.fx.srcCcy, cx[Tag::SrcCcy]);
+                    assign_txt(t.fx.trgtCcy, cx[Tag::TrgtCcy]);
+                    assign_txt(t.fx.unitCcy, cx[Tag::UnitCcy]);
+                    pugi::xml_node n = cx[Tag::XchgRate];
                     if (n) {
                         std::string s = txt(n);
                         std::replace(s.begin(), s.end(), ',', '.');
@@ -602,17 +603,17 @@ inline EntryTransaction parse_txdtls(const pugi::xml_node& tx) {
         }
 
         // 2.2 TxAmt
-        if (pugi::xml_node ta = child_any(ad, "TxAmt")) {
+        if (pugi::xml_node ta = adx[Tag::TxAmt]) {
             if (pugi::xml_node a = child_any(ta, "Amt")) {
-                t.fxTxAmt = parse_amount(a);
+                parse_amount(a, t.fxTxAmt);
                 t.hasFxTxAmt = true;
             }
         }
 
         // 2.3 CntrValAmt
-        if (pugi::xml_node cv = child_any(ad, "CntrValAmt")) {
+        if (pugi::xml_node cv = adx[Tag::CntrValAmt]) {
             if (pugi::xml_node a = child_any(cv, "Amt")) {
-                t.fxCounterValAmt = parse_amount(a);
+                parse_amount(a, t.fxCounterValAmt);
                 t.hasFxCntrVal = true;
             }
         }
@@ -620,16 +621,16 @@ inline EntryTransaction parse_txdtls(const pugi::xml_node& tx) {
 
     // ----- NEW: prioritize account-currency amount from AmtDtls (if reasonable) -----
     {
-        std::string accountCcy = find_account_ccy_from_tx(tx);
+        const std::string_view accountCcy = accountCcyHint ? *accountCcyHint : find_account_ccy_from_tx(tx);
 
         if (!accountCcy.empty()) {
-            if (pugi::xml_node ad = child_any(tx, "AmtDtls")) {
-                std::optional<CurrencyAmount> acctAmt = pick_amount_in_ccy(ad, accountCcy);
+            if (ad) {
+                pugi::xml_node acctAmt = pick_amount_in_ccy(adx, accountCcy);
 
                 // overwrite t.txAmount only if:
                 //   - we don’t yet have a Tx amount, OR
                 //   - the existing amount is not in account currency
-                if (acctAmt.has_value()) {
+                if (acctAmt) {
                     bool replace = false;
 
                     if (!t.txAmount.has_value()) {
@@ -639,7 +640,7 @@ inline EntryTransaction parse_txdtls(const pugi::xml_node& tx) {
                     }
 
                     if (replace) {
-                        t.txAmount = acctAmt.value();
+                        parse_amount(acctAmt, t.txAmount ? *t.txAmount : t.txAmount.emplace());
                     }
                 }
             }
@@ -647,9 +648,10 @@ inline EntryTransaction parse_txdtls(const pugi::xml_node& tx) {
     }
 
     // ----- NEW: derive FX rate consistently (detect inverted Src/Trgt) -----
-    {
-        const CurrencyAmount* aSrc = nullptr;
-        const CurrencyAmount* aTrg = nullptr;
+    if (fx) {
+        using A = std::remove_reference_t<decltype(t.fxTxAmt)>;
+        const A* aSrc = nullptr;
+        const A* aTrg = nullptr;
 
         // try to map amounts to the provided src/trgt
         if (t.fx.has) {
@@ -689,169 +691,288 @@ inline EntryTransaction parse_txdtls(const pugi::xml_node& tx) {
             // optional: extend FxRateInfo with 'bool inverted' and set it here
         }
     }
-
+}
+inline EntryTransaction parse_txdtls(const pugi::xml_node& tx, const std::string* accountCcyHint = nullptr,
+                                     unsigned sections = SectionAll) {
+    EntryTransaction t;
+    const std::string_view hint = accountCcyHint ? std::string_view(*accountCcyHint) : std::string_view();
+    parse_txdtls(tx, t, accountCcyHint ? &hint : nullptr, sections);
     return t;
 }
 
 
-inline Entry parse_entry(const pugi::xml_node& ntry){
-    Entry e;
-    pugi::xml_node a = child_any(ntry,"Amt"); if (a) e.amount = parse_amount(a);
-    pugi::xml_node c = child_any(ntry,"CdtDbtInd"); if (c) e.isCredit = (txt(c)=="CRDT");
-    
-    auto read_date_choice = [&](const pugi::xml_node& parent, const char* name) -> std::string {
-        pugi::xml_node n = child_any(parent, name);
-        if (!n) return {};
-        std::string d = desc_text(n, "Dt");
-        if (d.empty()) {
-            std::string dtm = desc_text(n, "DtTm");
-            if (!dtm.empty()) d = dtm.substr(0, 10); // "YYYY-MM-DD"
-        }
-        if (d.empty()) d = child_text(parent, name); // rare
-        return d;
-    };
-
-    auto parse_iso_date = [](const std::string& s) {
-        // expects YYYY-MM-DD (at least 10 chars)
-        if (s.size() < 10) return 0;
-        int y = std::stoi(s.substr(0, 4));
-        int m = std::stoi(s.substr(5, 2));
-        int d = std::stoi(s.substr(8, 2));
-        return y * 10000 + m * 100 + d;  // e.g. 20251008
-    };
+// BookgDt/ValDt: Dt, else the date part of DtTm, else the text of n (rare)
+inline std::string_view date_choice(const pugi::xml_node& n) {
+    if (!n) return {};
+    const auto dd = collect_desc(n, {Tag::Dt, Tag::DtTm});
+    std::string_view d = txt_view(dd[0]);
+    if (d.empty()) d = txt_view(dd[1]).substr(0, 10); // "YYYY-MM-DD"
+    if (d.empty()) d = txt_view(n);
+    return d;
+}
 
-    // in parse_entry(...)
-    e.bookingDate = read_date_choice(ntry, "BookgDt");
+// importOrdinal is left to the caller
+template <class E>
+inline void parse_entry(const pugi::xml_node& ntry, E& e, const std::string_view* accountCcy = nullptr,
+                        unsigned sections = SectionAll){
+    const ChildIndex ci(ntry);
+    parse_amount(ci[Tag::Amt], e.amount);
+    pugi::xml_node c = ci[Tag::CdtDbtInd]; e.isCredit = c && txt_view(c)=="CRDT";
+    
+    set_str(e.bookingDate, date_choice(ci[Tag::BookgDt]));
     e.bookingDateInt= parse_iso_date(e.bookingDate);
 
-    e.valueDate   = read_date_choice(ntry, "ValDt");
+    set_str(e.valueDate, date_choice(ci[Tag::ValDt]));
     e.valueDateInt  = parse_iso_date(e.valueDate);
     
-    pugi::xml_node r = child_any(ntry,"NtryRef"); if (r) e.entryRef = txt(r);
-    pugi::xml_node st= child_any(ntry,"Sts"); if (st) e.status = txt(st);
-    pugi::xml_node rv= child_any(ntry,"RvslInd"); if (rv) { std::string s = txt(rv); e.reversal = (s=="true"||s=="1"); }
+    assign_txt(e.entryRef, ci[Tag::NtryRef]);
+    assign_txt(e.status, ci[Tag::Sts]);
+    pugi::xml_node rv= ci[Tag::RvslInd];
+    const std::string_view rvs = txt_view(rv);
+    e.reversal = rv && (rvs=="true"||rvs=="1");
 	
-	pugi::xml_node asr = child_any(ntry, "AcctSvcrRef");
-    if (asr) e.acctSvcrRef = txt(asr);
-
-    pugi::xml_node nd = child_any(ntry,"NtryDtls");
-    if (nd) {
-        int txOrdinal = 0; // local counter per Entry
-        for (pugi::xml_node td = nd.first_child(); td; td = td.next_sibling()) {
-            if (!isln(td,"TxDtls")) continue;
-            EntryTransaction tx = parse_txdtls(td);
-            tx.importOrdinal = txOrdinal++;     // preserve TxDtls order
-            e.transactions.push_back(std::move(tx));
-        }
+    assign_txt(e.acctSvcrRef, ci[Tag::AcctSvcrRef]);
+
+    pugi::xml_node nd = ci[Tag::NtryDtls];
+    std::size_t txOrdinal = 0; // local counter per Entry
+    for (pugi::xml_node td = nd.first_child(); td; td = td.next_sibling()) {
+        if (!isln(td,"TxDtls")) continue;
+        auto& tx = reuse_slot(e.transactions, txOrdinal);
+        parse_txdtls(td, tx, accountCcy, sections);
+        tx.importOrdinal = (int)txOrdinal++;     // preserve TxDtls order
     }
+    e.transactions.resize(txOrdinal);
+}
+inline Entry parse_entry(const pugi::xml_node& ntry, const std::string* accountCcy = nullptr,
+                         unsigned sections = SectionAll){
+    Entry e;
+    const std::string_view hint = accountCcy ? std::string_view(*accountCcy) : std::string_view();
+    parse_entry(ntry, e, accountCcy ? &hint : nullptr, sections);
     return e;
 }
 
-inline Balance parse_balance(const pugi::xml_node& bal) {
-    Balance b;
-
+template <class B>
+inline void parse_balance(const pugi::xml_node& bal, B& b) {
     // --- Type (OPBD, PRCD, CLBD, ...) sicher extrahieren ---
-    if (pugi::xml_node tp = child_any(bal, "Tp")) {
+    const ChildIndex ci(bal);
+    set_str(b.type, {});
+    if (pugi::xml_node tp = ci[Tag::Tp]) {
         // 1) Common case: <Tp><CdOrPrtry><Cd>CLBD</Cd></CdOrPrtry></Tp>
-        if (pugi::xml_node cop = child_any(tp, "CdOrPrtry")) {
-            if (pugi::xml_node cd = child_any(cop, "Cd"))      b.type = txt(cd);
-            if (b.type.empty()) {
-                if (pugi::xml_node pr = child_any(cop, "Prtry")) b.type = txt(pr);
-            }
-        }
+        pugi::xml_node cop = child_any(tp, "CdOrPrtry");
+        assign_txt(b.type, child_any(cop, "Cd"));
+        if (b.type.empty()) assign_txt(b.type, child_any(cop, "Prtry"));
         // 2) Fallback: <Tp><Cd>CLBD</Cd></Tp> bzw. <Tp><Prtry>...</Prtry></Tp>
+        if (b.type.empty()) assign_txt(b.type, child_any(tp, "Cd"));
+        if (b.type.empty()) assign_txt(b.type, child_any(tp, "Prtry"));
+        // 3) Final fallback: recursive search (one walk for both names)
         if (b.type.empty()) {
-            if (pugi::xml_node cd = child_any(tp, "Cd"))      b.type = txt(cd);
-            if (b.type.empty()) {
-                if (pugi::xml_node pr = child_any(tp, "Prtry")) b.type = txt(pr);
-            }
-        }
-        // 3) Final fallback: recursive search (desc_any)
-        if (b.type.empty()) {
-            if (pugi::xml_node cd = desc_any(tp, "Cd"))       b.type = txt(cd);
-            if (b.type.empty()) {
-                if (pugi::xml_node pr = desc_any(tp, "Prtry"))  b.type = txt(pr);
-            }
+            const auto cp = collect_desc(tp, {Tag::Cd, Tag::Prtry});
+            assign_txt(b.type, cp[0]);
+            if (b.type.empty()) assign_txt(b.type, cp[1]);
         }
     }
 
     // --- Amount ---
-    if (pugi::xml_node a = child_any(bal, "Amt"))
-        b.amount = parse_amount(a);  // set currency + minor
+    parse_amount(ci[Tag::Amt], b.amount);  // set currency + minor
 
     // --- CdtDbtInd (optional; set by many banks) ---
-    if (pugi::xml_node cdi = child_any(bal, "CdtDbtInd")) {
-        const std::string v = txt(cdi);
-        b.hasCdtDbtInd = true;
-        b.isCredit     = (v == "CRDT");
-    }
+    pugi::xml_node cdi = ci[Tag::CdtDbtInd];
+    b.hasCdtDbtInd = (bool)cdi;
+    b.isCredit     = cdi ? (txt_view(cdi) == "CRDT") : true;
 
     // --- Date ---
-    if (pugi::xml_node d = child_any(bal, "Dt"))
-        b.date = desc_text(d, "Dt");
+    pugi::xml_node d = ci[Tag::Dt];
+    assign_txt(b.date, desc_any(d, "Dt"));
     if (b.date.empty())
-        b.date = child_text(bal, "Dt");
-
+        assign_txt(b.date, d);
+}
+inline Balance parse_balance(const pugi::xml_node& bal) {
+    Balance b;
+    parse_balance(bal, b);
     return b;
 }
 
+template <class Ac>
+inline void parse_account(const pugi::xml_node& acct, Ac& a){
+    const ChildIndex ci(acct);
+    parse_account_id(ci[Tag::Id], a.id);
+    assign_txt(a.name, ci[Tag::Nm]);
+    assign_txt(a.currency, ci[Tag::Ccy]);
+    parse_agent(ci[Tag::Svcr], a.servicer);
+}
 inline Account parse_account(const pugi::xml_node& acct){
     Account a;
-    pugi::xml_node id = child_any(acct,"Id"); if (id) a.id = parse_account_id(id);
-    pugi::xml_node nm = child_any(acct,"Nm"); if (nm) a.name = txt(nm);
-    pugi::xml_node cy = child_any(acct,"Ccy"); if (cy) a.currency = txt(cy);
-    pugi::xml_node sv = child_any(acct,"Svcr"); if (sv) a.servicer = parse_agent(sv);
+    parse_account(acct, a);
     return a;
 }
 
+template <class G>
+inline void parse_group_header(const pugi::xml_node& gh, G& g){
+    assign_txt(g.msgId, child_any(gh,"MsgId"));
+    assign_txt(g.creationDateTime, child_any(gh,"CreDtTm"));
+    assign_txt(g.messageRecipient, child_any(child_any(gh,"MsgRcpt"),"Nm"));
+}
 inline GroupHeader parse_group_header(const pugi::xml_node& gh){
     GroupHeader g;
-    pugi::xml_node m = child_any(gh,"MsgId"); if (m) g.msgId = txt(m);
-    pugi::xml_node c = child_any(gh,"CreDtTm"); if (c) g.creationDateTime = txt(c);
-    pugi::xml_node r = child_any(gh,"MsgRcpt");
-    if (r) { pugi::xml_node nm = child_any(r,"Nm"); if (nm) g.messageRecipient = txt(nm); }
+    parse_group_header(gh, g);
     return g;
 }
 
-inline Statement parse_statement(const pugi::xml_node& stmt, const GroupHeader* optHdr){
-    Statement s; 
-    if (optHdr) s.groupHeader = *optHdr;
+// ---------- Parse filter ----------
+// Conditions evaluated while mapping, before anything of a statement's
+// entries or an entry's NtryDtls is materialized. A rejected statement is
+// left out of the document (and not reported by parse_stream()), a rejected
+// entry is skipped without being mapped. Empty / zero members match all.
+// importOrdinal keeps counting the skipped entries, so kept entries have the
+// same ordinal (and fingerprint) as in an unfiltered parse.
+struct ParseFilter {
+    enum class Direction { Any, Credit, Debit };
+
+    // statements
+    std::vector<std::string> ibans;     // Acct/Id/IBAN, else Othr/Id; case and spaces ignored
+    std::string currency;               // Acct/Ccy
+
+    // entries; dates as YYYYMMDD like Entry::bookingDateInt, both ends
+    // inclusive, 0 = open. An entry without a valid date fails a set range.
+    int bookingFrom = 0, bookingTo = 0;
+    int valueFrom = 0, valueTo = 0;
+    Direction direction = Direction::Any;   // CdtDbtInd
+    std::vector<std::string> statuses;      // Entry::status, e.g. {"BOOK"}
+    std::optional<std::int64_t> minAmount;  // Ntry/Amt in minor units (unsigned)
+    std::optional<std::int64_t> maxAmount;
+
+    bool filters_statements() const { return !ibans.empty() || !currency.empty(); }
+    bool filters_entries() const
+    {
+        return bookingFrom || bookingTo || valueFrom || valueTo || direction != Direction::Any
+            || !statuses.empty() || minAmount || maxAmount;
+    }
+    bool empty() const { return !filters_statements() && !filters_entries(); }
+
+    template <class Ac>
+    bool accepts_account(const Ac& a) const
+    {
+        if (!currency.empty() && std::string_view(a.currency) != currency) return false;
+        if (ibans.empty()) return true;
+        const std::string_view id = !a.id.iban.empty() ? std::string_view(a.id.iban) : std::string_view(a.id.other);
+        for (const auto& want : ibans)
+            if (same_iban(id, want)) return true;
+        return false;
+    }
+
+    static bool same_iban(std::string_view a, std::string_view b)
+    {
+        auto up = [](char c) { return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c; };
+        std::size_t i = 0, j = 0;
+        for (;;) {
+            while (i < a.size() && a[i] == ' ') ++i;
+            while (j < b.size() && b[j] == ' ') ++j;
+            if (i == a.size() || j == b.size()) return i == a.size() && j == b.size();
+            if (up(a[i++]) != up(b[j++])) return false;
+        }
+    }
+};
 
-    if (pugi::xml_node id = child_any(stmt,"Id"))      s.id = txt(id);
-    if (pugi::xml_node cd = child_any(stmt,"CreDtTm")) s.creationDateTime = txt(cd);
-    if (pugi::xml_node ac = child_any(stmt,"Acct"))    s.account = parse_account(ac);
-
-    // helper: compare local element name (without namespace prefix)
-    auto local_name_eq = [](const pugi::xml_node& n, const char* want)->bool {
-        if (n.type() != pugi::node_element) 
-		{
-			return false;
-		}
-        const char* full = n.name();
-        const char* colon = std::strchr(full, ':');
-        const char* local = colon ? colon + 1 : full;
-        return std::strcmp(local, want) == 0;
+// f against the Ntry-level fields only (CdtDbtInd, Sts, Amt, BookgDt, ValDt),
+// read as views into the DOM; nothing is allocated
+inline bool entry_matches(const pugi::xml_node& ntry, const ParseFilter& f) {
+    const ChildIndex ci(ntry);
+    if (f.direction != ParseFilter::Direction::Any) {
+        const bool credit = txt_view(ci[Tag::CdtDbtInd]) == "CRDT";
+        if (credit != (f.direction == ParseFilter::Direction::Credit)) return false;
+    }
+    if (!f.statuses.empty()) {
+        const std::string_view sts = txt_view(ci[Tag::Sts]);
+        if (std::find(f.statuses.begin(), f.statuses.end(), sts) == f.statuses.end()) return false;
+    }
+    if (f.minAmount || f.maxAmount) {
+        struct { std::string_view currency; std::int64_t minor = 0; } amt;
+        parse_amount(ci[Tag::Amt], amt);
+        if (f.minAmount && amt.minor < *f.minAmount) return false;
+        if (f.maxAmount && amt.minor > *f.maxAmount) return false;
+    }
+    auto in_range = [](const pugi::xml_node& n, int from, int to) {
+        if (!from && !to) return true;
+        const int d = parse_iso_date(date_choice(n));
+        return d && (!from || d >= from) && (!to || d <= to);
     };
-    
+    return in_range(ci[Tag::BookgDt], f.bookingFrom, f.bookingTo)
+        && in_range(ci[Tag::ValDt], f.valueFrom, f.valueTo);
+}
+
+// everything but the entries
+template <class S>
+inline void parse_statement_head(const pugi::xml_node& stmt, const decltype(S::groupHeader)* optHdr, S& s,
+                                 unsigned sections = SectionAll){
+    if (optHdr) s.groupHeader = *optHdr;
+    else parse_group_header(pugi::xml_node(), s.groupHeader);
+
+    assign_txt(s.id, child_any(stmt,"Id"));
+    assign_txt(s.creationDateTime, child_any(stmt,"CreDtTm"));
+    parse_account(child_any(stmt,"Acct"), s.account);
+
     // --- Balances: directly under <Stmt> ---
-	for (pugi::xml_node n = stmt.first_child(); n; n = n.next_sibling()){
+    std::size_t nb = 0;
+	for (pugi::xml_node n = (sections & SectionBalances) ? stmt.first_child() : pugi::xml_node(); n; n = n.next_sibling()){
 		if (!isln(n, "Bal")) continue;
-		s.balances.push_back(parse_balance(n));
+		parse_balance(n, reuse_slot(s.balances, nb++));
 	}
+    s.balances.resize(nb);
+}
+
+// false if filter rejects the account; s then holds the head only
+template <class S>
+inline bool parse_statement(const pugi::xml_node& stmt, const decltype(S::groupHeader)* optHdr, S& s,
+                            unsigned sections = SectionAll, const ParseFilter* filter = nullptr){
+    parse_statement_head(stmt, optHdr, s, sections);
+    if (filter && !filter->accepts_account(s.account)) {
+        s.entries.resize(0);   // Entry vector or ArenaVector
+        return false;
+    }
+    const bool entryFilter = filter && filter->filters_entries();
 
     // --- Entries: directly under <Stmt> ---
-    int ordinal = 0;
+    std::size_t ordinal = 0, kept = 0;
 	for (pugi::xml_node n = stmt.first_child(); n; n = n.next_sibling()){
 		if (!isln(n, "Ntry")) continue;
-		
-        Entry e = parse_entry(n);
-        e.importOrdinal = ordinal++;      // assign ordinal in original XML order
-        s.entries.push_back(std::move(e));
-	}
+		if (entryFilter && !entry_matches(n, *filter)) { ++ordinal; continue; }
 
+        auto& e = reuse_slot(s.entries, kept++);
+        parse_entry(n, e, nullptr, sections);
+        e.importOrdinal = (int)ordinal++;      // assign ordinal in original XML order
+	}
+    s.entries.resize(kept);
+    return true;
+}
+inline Statement parse_statement(const pugi::xml_node& stmt, const GroupHeader* optHdr,
+                                 unsigned sections = SectionAll, const ParseFilter* filter = nullptr){
+    Statement s;
+    parse_statement(stmt, optHdr, s, sections, filter);
     return s;
 }
 
+// ---------- Parse options ----------
+struct ParseOptions {
+    // Maps the <Ntry> elements of a document concurrently on this pool once
+    // the DOM is loaded (nullptr = sequential). Order and importOrdinal are the
+    // same as in sequential mode. Only used for Document, DocumentView is
+    // always mapped sequentially (its arena is not thread-safe).
+    ThreadPool* pool = nullptr;
+    std::size_t parallelMinEntries = 512;  // smaller documents stay sequential
+    std::size_t entriesPerTask = 128;
+
+    // ParseSection flags of the parts to map; parse_sections_for() in
+    // camt_csv.hpp derives them from the export columns
+    unsigned sections = SectionAll;
+
+    // statements / entries to keep (see ParseFilter), in every Parser mode
+    // including parse_stream(); not used by DocumentView
+    ParseFilter filter;
+
+    // filled in by Parser (bytes, nodes, counts, load/map times); only with CAMT_STATS
+    Stats* stats = nullptr;
+};
+
 inline pugi::xml_node find_payload(const pugi::xml_node& root){
     if (isln(root,"BkToCstmrStmt")||isln(root,"BkToCstmrDbtCdtNtfctn")||isln(root,"BkToCstmrAcctRpt"))
         return root;
@@ -860,12 +981,10 @@ inline pugi::xml_node find_payload(const pugi::xml_node& root){
             if (isln(c,"BkToCstmrStmt")||isln(c,"BkToCstmrDbtCdtNtfctn")||isln(c,"BkToCstmrAcctRpt"))
                 return c;
     }
-    // generic depth-first search
-    return desc_any(root, "BkToCstmrStmt") ?
-           desc_any(root, "BkToCstmrStmt") :
-           (desc_any(root, "BkToCstmrDbtCdtNtfctn") ?
-                desc_any(root, "BkToCstmrDbtCdtNtfctn") :
-                desc_any(root, "BkToCstmrAcctRpt"));
+    // generic depth-first search, one walk; a statement wins over a
+    // notification, a notification over a report (first match each)
+    const auto p = collect_desc(root, {Tag::BkToCstmrStmt, Tag::BkToCstmrDbtCdtNtfctn, Tag::BkToCstmrAcctRpt});
+    return p[0] ? p[0] : (p[1] ? p[1] : p[2]);
 }
 
 inline DocKind detect_kind(const pugi::xml_node& payload){
@@ -875,35 +994,314 @@ inline DocKind detect_kind(const pugi::xml_node& payload){
     return DocKind::Unknown;
 }
 
-// ---------- Parser-Class ----------
-class Parser {
-public:
-    
-    bool parse_file(const std::string& utf8Path, Document& out, std::string* error = nullptr) const
+// DOM -> model. The statements are written to out.statements from index
+// 'first' on (Parser appends, ParserSession overwrites from 0 and reuses the
+// elements of the previous parse); the vector is truncated behind the last one.
+template <class D>
+inline bool parse_document(const pugi::xml_document& doc, D& out, std::size_t first, std::string* error,
+                           const ParseOptions* opt = nullptr) {
+    pugi::xml_node root = doc.document_element();
+    if (!root)
     {
-        // Build a filesystem::path from UTF-8 (works on Windows and POSIX)
-        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if(error)
+        {
+            *error="Empty document";
+        }
+        return false;
+    }
+    pugi::xml_node payload = find_payload(root);
+    out.kind = detect_kind(payload);
+    if (out.kind==DocKind::Unknown)
+    {
+        if(error)
+        {
+            *error="Unsupported CAMT root";
+        }
+        return false;
+    }
 
-        // Optional: fast sanity checks that don't throw (use error_code overloads)
-        std::error_code ecStat;
-        const auto s = std::filesystem::status(p, ecStat);
-        if (ecStat) {
-            if (error) {
-                *error = std::string("Cannot query file status for '")
-                         + utf8Path + "': " + ecStat.message();
+    // optional GrpHdr above the statements
+    using S = std::remove_reference_t<decltype(out.statements[0])>;
+    std::optional<decltype(S::groupHeader)> gh;
+    pugi::xml_node g = child_any(payload,"GrpHdr");
+    if (g)
+    {
+        parse_group_header(g, gh.emplace());
+    }
+
+    const unsigned sections = opt ? opt->sections : SectionAll;
+    const ParseFilter* filter = (opt && !opt->filter.empty()) ? &opt->filter : nullptr;
+    std::size_t ns = first;
+    if constexpr (std::is_same_v<D, Document>) {
+        if (opt && opt->pool) {
+            // statement heads first, with presized entry slots; then all entries
+            // of the document as one flat list, any order. The entry filter
+            // runs here, sequentially: it is cheap next to the mapping.
+            const bool entryFilter = filter && filter->filters_entries();
+            std::vector<pugi::xml_node> ntry;
+            std::vector<int> ordinals;   // XML position of ntry[j] in its statement
+            std::vector<Entry*> slots;
+            for (pugi::xml_node n = payload.first_child(); n; n = n.next_sibling()){
+                if (!(isln(n,"Stmt") || isln(n,"Ntfctn") || isln(n,"Rpt"))) continue;
+                Statement& s = reuse_slot(out.statements, ns);
+                parse_statement_head(n, gh ? &*gh : nullptr, s, sections);
+                if (filter && !filter->accepts_account(s.account)) continue; // slot is reused
+                ++ns;
+                const std::size_t base = ntry.size();
+                int ordinal = 0;
+                for (pugi::xml_node c = n.first_child(); c; c = c.next_sibling()) {
+                    if (!isln(c, "Ntry")) continue;
+                    if (!entryFilter || entry_matches(c, *filter)) {
+                        ntry.push_back(c);
+                        ordinals.push_back(ordinal);
+                    }
+                    ++ordinal;
+                }
+                s.entries.resize(ntry.size() - base);
             }
-            return false;
-        }
-        if (!std::filesystem::exists(s)) {
-            if (error) {
-                *error = std::string("File not found: '") + utf8Path + "'";
+            out.statements.resize(ns);
+
+            // pointers are taken after the last resize of out.statements
+            slots.reserve(ntry.size());
+            for (std::size_t i = first; i < ns; ++i) {
+                std::vector<Entry>& entries = out.statements[i].entries;
+                for (std::size_t k = 0; k < entries.size(); ++k) {
+                    entries[k].importOrdinal = ordinals[slots.size()];
+                    slots.push_back(&entries[k]);
+                }
             }
+
+            auto map_range = [&](std::size_t b, std::size_t e) {
+                for (std::size_t j = b; j < e; ++j) parse_entry(ntry[j], *slots[j], nullptr, sections);
+            };
+            if (ntry.size() < opt->parallelMinEntries) map_range(0, ntry.size());
+            else opt->pool->parallel_for(ntry.size(), opt->entriesPerTask, map_range);
+            return true;
+        }
+    }
+    for (pugi::xml_node n = payload.first_child(); n; n = n.next_sibling()){
+        if (isln(n,"Stmt") || isln(n,"Ntfctn") || isln(n,"Rpt"))
+            if (parse_statement(n, gh ? &*gh : nullptr, reuse_slot(out.statements, ns), sections, filter))
+                ++ns; // a rejected statement's slot is reused
+    }
+    out.statements.resize(ns);
+    return true;
+}
+
+// fast sanity checks that don't throw (use error_code overloads)
+inline bool check_input_file(const std::filesystem::path& p, const std::string& utf8Path, std::string* error)
+{
+    std::error_code ecStat;
+    const auto s = std::filesystem::status(p, ecStat);
+    if (ecStat) {
+        if (error) {
+            *error = std::string("Cannot query file status for '")
+                     + utf8Path + "': " + ecStat.message();
+        }
+        return false;
+    }
+    if (!std::filesystem::exists(s)) {
+        if (error) {
+            *error = std::string("File not found: '") + utf8Path + "'";
+        }
+        return false;
+    }
+    if (std::filesystem::is_directory(s)) {
+        if (error) {
+            *error = std::string("Path is a directory, not a file: '") + utf8Path + "'";
+        }
+        return false;
+    }
+    return true;
+}
+
+// ---------- Streaming input (camt.053/054 files of arbitrary size) ----------
+// Callbacks of Parser::parse_stream(). The statement header passed to the
+// callbacks carries Id/CreDtTm/Acct/GrpHdr and the balances, but no entries.
+class EntrySink {
+public:
+    virtual ~EntrySink() = default;
+
+    virtual void on_document(DocKind kind) { (void)kind; }
+    virtual void on_group_header(const GroupHeader& gh) { (void)gh; }
+    // before the first entry of a statement (or at its end if it has none)
+    virtual void on_statement(const Statement& header) { (void)header; }
+    // return false to stop parsing
+    virtual bool on_entry(const Statement& header, Entry&& entry) = 0;
+    // header incl. balances that followed the entries (non-standard, but seen)
+    virtual void on_statement_end(const Statement& header) { (void)header; }
+};
+
+// Incremental tokenizer over a std::istream. Only the current token and the
+// element being captured are buffered, everything before is dropped.
+class XmlChunkReader {
+public:
+    enum class Token { StartTag, EndTag, EmptyTag, Other, Eof, Error };
+
+    explicit XmlChunkReader(std::istream& is, std::size_t chunkSize = 64 * 1024)
+        : is_(is), chunk_(chunkSize ? chunkSize : 1) {}
+
+    Token next() {
+        tokBegin_ = pos_;
+        if (pos_ >= buf_.size() && !fill()) return failed_ ? Token::Error : Token::Eof;
+        if (first_) {
+            first_ = false;
+            if (!ensure(3)) return failed_ ? Token::Error : Token::Eof;
+            const unsigned char b0 = (unsigned char)buf_[pos_], b1 = (unsigned char)buf_[pos_+1];
+            if ((b0 == 0xFE && b1 == 0xFF) || (b0 == 0xFF && b1 == 0xFE) || b0 == 0 || b1 == 0)
+                return error("UTF-16/32 input is not supported in streaming mode");
+            if (b0 == 0xEF && b1 == 0xBB && (unsigned char)buf_[pos_+2] == 0xBF) pos_ += 3;
+            tokBegin_ = pos_;
+        }
+
+        // character data: whatever is buffered up to the next '<'
+        if (buf_[pos_] != '<') {
+            const std::size_t lt = buf_.find('<', pos_);
+            pos_ = (lt == std::string::npos) ? buf_.size() : lt;
+            return Token::Other;
+        }
+
+        ensure(9); // longest prefix to classify ("<![CDATA[")
+        std::size_t at = pos_ + 1;
+        const std::string_view head(buf_.data() + pos_, buf_.size() - pos_);
+        if (head.compare(0, 4, "<!--") == 0) {
+            at = pos_ + 4;
+            if (!scan_to(at, "-->")) return error("Error parsing comment");
+        } else if (head.compare(0, 9, "<![CDATA[") == 0) {
+            at = pos_ + 9;
+            if (!scan_to(at, "]]>")) return error("Error parsing CDATA section");
+        } else if (head.compare(0, 2, "<!") == 0) {
+            if (!scan_markup(at, true)) return error("Error parsing document type declaration");
+        } else if (head.compare(0, 2, "<?") == 0) {
+            at = pos_ + 2;
+            if (!scan_to(at, "?>")) return error("Error parsing document declaration/processing instruction");
+            read_declaration(std::string_view(buf_.data() + tokBegin_, at - tokBegin_));
+        } else {
+            if (!scan_markup(at, false)) return error("Error parsing start element tag");
+            pos_ = at;
+            const bool isEnd = buf_[tokBegin_ + 1] == '/';
+            nameBegin_ = tokBegin_ + (isEnd ? 2 : 1);
+            nameEnd_ = nameBegin_;
+            while (nameEnd_ < pos_ && !std::strchr(" \t\r\n/>", buf_[nameEnd_])) ++nameEnd_;
+            if (nameEnd_ == nameBegin_) return error(isEnd ? "Error parsing end element tag" : "Error parsing start element tag");
+            if (isEnd) return Token::EndTag;
+            return buf_[pos_ - 2] == '/' ? Token::EmptyTag : Token::StartTag;
+        }
+        pos_ = at;
+        return Token::Other;
+    }
+
+    // qualified/local name of the last tag token
+    std::string_view qname() const { return std::string_view(buf_.data() + nameBegin_, nameEnd_ - nameBegin_); }
+    std::string_view local_name() const {
+        const std::string_view q = qname();
+        const std::size_t c = q.rfind(':');
+        return c == std::string_view::npos ? q : q.substr(c + 1);
+    }
+    // raw bytes of the last token
+    std::string_view token() const { return std::string_view(buf_.data() + tokBegin_, pos_ - tokBegin_); }
+
+    // capture from the start of the last token up to the end of the current one
+    void begin_capture() { capturing_ = true; capBegin_ = tokBegin_; }
+    std::string_view capture() const { return std::string_view(buf_.data() + capBegin_, pos_ - capBegin_); }
+    void end_capture() { capturing_ = false; }
+
+    pugi::xml_encoding encoding() const { return encoding_; }
+    const std::string& error_message() const { return error_; }
+
+private:
+    Token error(const char* msg) { failed_ = true; error_ = msg; return Token::Error; }
+
+    // append the next chunk; drops everything that is no longer needed and
+    // rebases *extra (a scan position) accordingly
+    bool fill(std::size_t* extra = nullptr) {
+        if (eof_) return false;
+        const std::size_t keep = capturing_ ? capBegin_ : tokBegin_;
+        if (keep > 0) {
+            buf_.erase(0, keep);
+            pos_ -= keep; tokBegin_ -= keep;
+            if (capturing_) capBegin_ -= keep;
+            if (extra) *extra -= keep;
+        }
+        const std::size_t old = buf_.size();
+        buf_.resize(old + chunk_);
+        is_.read(&buf_[old], static_cast<std::streamsize>(chunk_));
+        const std::size_t got = static_cast<std::size_t>(is_.gcount());
+        buf_.resize(old + got);
+        if (got == 0) {
+            eof_ = true;
+            if (is_.bad()) { failed_ = true; error_ = "Error reading from file/stream"; }
             return false;
         }
-        if (std::filesystem::is_directory(s)) {
-            if (error) {
-                *error = std::string("Path is a directory, not a file: '") + utf8Path + "'";
+        return true;
+    }
+    bool ensure(std::size_t n) {
+        while (buf_.size() - pos_ < n) { if (!fill()) return false; }
+        return true;
+    }
+    // advance 'at' behind the next occurrence of pat
+    bool scan_to(std::size_t& at, const char* pat) {
+        const std::size_t n = std::strlen(pat);
+        for (;;) {
+            const std::size_t f = buf_.find(pat, at, n);
+            if (f != std::string::npos) { at = f + n; return true; }
+            at = std::max(at, buf_.size() >= n ? buf_.size() - (n - 1) : std::size_t(0));
+            if (!fill(&at)) return false;
+        }
+    }
+    // advance 'at' behind the closing '>' of a tag (quotes respected, and
+    // [...] internal subsets for <!DOCTYPE>)
+    bool scan_markup(std::size_t& at, bool brackets) {
+        char quote = 0;
+        int depth = 0;
+        for (;;) {
+            while (at < buf_.size()) {
+                const char c = buf_[at++];
+                if (quote) { if (c == quote) quote = 0; }
+                else if (c == '"' || c == '\'') quote = c;
+                else if (brackets && c == '[') ++depth;
+                else if (brackets && c == ']') --depth;
+                else if (c == '>' && depth <= 0) return true;
             }
+            if (!fill(&at)) return false;
+        }
+    }
+    void read_declaration(std::string_view decl) {
+        if (decl.compare(0, 5, "<?xml") != 0) return;
+        const std::size_t e = decl.find("encoding");
+        if (e == std::string_view::npos) return;
+        const std::size_t q = decl.find_first_of("\"'", e);
+        if (q == std::string_view::npos) return;
+        const std::size_t qe = decl.find(decl[q], q + 1);
+        if (qe == std::string_view::npos) return;
+        std::string enc(decl.substr(q + 1, qe - q - 1));
+        std::transform(enc.begin(), enc.end(), enc.begin(), [](unsigned char c){ return (char)std::tolower(c); });
+        if (enc == "iso-8859-1" || enc == "latin1" || enc == "latin-1") encoding_ = pugi::encoding_latin1;
+    }
+
+    std::istream& is_;
+    std::size_t chunk_;
+    std::string buf_;
+    std::size_t pos_ = 0, tokBegin_ = 0, capBegin_ = 0;
+    std::size_t nameBegin_ = 0, nameEnd_ = 0;
+    bool capturing_ = false, eof_ = false, failed_ = false, first_ = true;
+    pugi::xml_encoding encoding_ = pugi::encoding_utf8;
+    std::string error_;
+};
+
+// ---------- Parser-Class ----------
+class Parser {
+public:
+    Parser() = default;
+    explicit Parser(const ParseOptions& opt) : opt_(opt) {}
+
+    const ParseOptions& options() const { return opt_; }
+
+    bool parse_file(const std::string& utf8Path, Document& out, std::string* error = nullptr) const
+    {
+        // Build a filesystem::path from UTF-8 (works on Windows and POSIX)
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if (!check_input_file(p, utf8Path, error)) {
             return false;
         }
 
@@ -924,9 +1322,66 @@ public:
         return parse_file(in, out, error);
     }
 
+    // Same as parse_file(path), but the file is memory-mapped and parsed in
+    // place (load_buffer_inplace): no read() copies and no buffer growth.
+    bool parse_mapped_file(const std::string& utf8Path, Document& out, std::string* error = nullptr) const
+    {
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if (!check_input_file(p, utf8Path, error)) {
+            return false;
+        }
+
+        MappedFile mf;
+        std::string sysMsg;
+        if (!mf.open(p, &sysMsg)) {
+            if (error) {
+                *error = std::string("Open failed for '") + utf8Path + "': " + sysMsg;
+            }
+            return false;
+        }
+
+        // the document references the mapping, both live until parse_doc() is done
+        CAMT_STAT_SCOPE(scope, opt_.stats);
+        CAMT_STAT_ADD(opt_.stats, bytesRead, mf.size());
+        return parse_inplace(mf.data(), mf.size(), out, error);
+    }
+
+    // gzip is decompressed while reading, a ZIP archive is read completely first
     bool parse_file(std::istream& is, Document& out, std::string* error=nullptr) const {
+        switch (peek_compression(is)) {
+        case Compression::Gzip: {
+#ifdef USE_ZLIB
+            InflateStreamBuf gz(is);
+            std::istream in(&gz);
+            const bool ok = parse_file(in, out, error);
+            if (gz.failed()) return fail_with(error, gz.error_message());
+            return ok;
+#else
+            return fail_with(error, std::string("gzip input: ") + detail::no_zlib_message());
+#endif
+        }
+        case Compression::Zip: {
+            std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+            return parse_buffer_inplace(&data[0], data.size(), out, error);
+        }
+        case Compression::None:
+            break;
+        }
+        CAMT_STAT_SCOPE(scope, opt_.stats);
+        CAMT_STAT_TIMER(load, opt_.stats, Load);
+#ifdef CAMT_STATS
+        const std::istream::pos_type start = is.tellg();
+#endif
         pugi::xml_document doc;
         pugi::xml_parse_result res = doc.load(is, pugi::parse_default | pugi::parse_declaration);
+        CAMT_STAT_STOP(load);
+#ifdef CAMT_STATS
+        if (start != std::istream::pos_type(-1)) {
+            is.clear();
+            const std::istream::pos_type end = is.tellg();
+            if (end != std::istream::pos_type(-1)) CAMT_STAT_ADD(opt_.stats, bytesRead, (std::uint64_t)(end - start));
+        }
+#endif
         if (!res)
         {
             if(error)
@@ -940,8 +1395,19 @@ public:
     }
 
     bool parse_string(const std::string& xml_utf8, Document& out, std::string* error=nullptr) const {
+        return parse_buffer(xml_utf8.data(), xml_utf8.size(), out, error);
+    }
+
+    // XML, gzip or ZIP (see camt_archive.hpp) in memory
+    bool parse_buffer(const char* data, std::size_t size, Document& out, std::string* error=nullptr) const {
+        CAMT_STAT_SCOPE(scope, opt_.stats);
+        CAMT_STAT_ADD(opt_.stats, bytesRead, size);
+        const Compression c = detect_compression(data, size);
+        if (c != Compression::None) return parse_compressed(data, size, c, out, error);
+        CAMT_STAT_TIMER(load, opt_.stats, Load);
         pugi::xml_document doc;
-        pugi::xml_parse_result res = doc.load_buffer(xml_utf8.data(), xml_utf8.size(), pugi::parse_default | pugi::parse_declaration);
+        pugi::xml_parse_result res = doc.load_buffer(data, size, pugi::parse_default | pugi::parse_declaration);
+        CAMT_STAT_STOP(load);
         if (!res)
         {
             if(error)
@@ -954,43 +1420,296 @@ public:
         return parse_doc(doc, out, error);
     }
 
-private:
-    bool parse_doc(const pugi::xml_document& doc, Document& out, std::string* error) const {
-        pugi::xml_node root = doc.document_element();
-        if (!root)
-        {
-            if(error)
-            {
-                *error="Empty document";
-            }
+    // like parse_buffer(), but XML is parsed in place: data is modified
+    bool parse_buffer_inplace(char* data, std::size_t size, Document& out, std::string* error=nullptr) const {
+        CAMT_STAT_SCOPE(scope, opt_.stats);
+        CAMT_STAT_ADD(opt_.stats, bytesRead, size);
+        return parse_inplace(data, size, out, error);
+    }
+
+    // Streaming mode: tokenizes the input chunk by chunk and loads only one
+    // element at a time (GrpHdr, the statement head, each Ntry) into a small
+    // DOM, which is then mapped with the same functions as parse_file().
+    // Memory is bounded by the largest single <Ntry>. Callbacks may already
+    // have been invoked when a syntax error further down is reported.
+    bool parse_stream(std::istream& is, EntrySink& sink, std::string* error = nullptr,
+                      std::size_t chunkSize = 64 * 1024) const
+    {
+        switch (peek_compression(is)) {
+        case Compression::Gzip: {
+#ifdef USE_ZLIB
+            InflateStreamBuf gz(is, InflateStreamBuf::Format::Gzip, chunkSize);
+            std::istream in(&gz);
+            const bool ok = parse_stream(in, sink, error, chunkSize);
+            if (gz.failed()) return fail_with(error, gz.error_message());
+            return ok;
+#else
+            return fail_with(error, std::string("gzip input: ") + detail::no_zlib_message());
+#endif
+        }
+        case Compression::Zip:
+            return fail_with(error, "ZIP archives cannot be streamed, use ZipArchive::open_member()");
+        case Compression::None:
+            break;
+        }
+
+        using Token = XmlChunkReader::Token;
+        XmlChunkReader rd(is, chunkSize);
+        pugi::xml_document frag;
+
+        auto fail = [&](const std::string& msg) {
+            if (error) *error = msg;
             return false;
+        };
+        auto load = [&](std::string_view xml, pugi::xml_node& out) {
+            pugi::xml_parse_result res = frag.load_buffer(xml.data(), xml.size(), pugi::parse_default, rd.encoding());
+            if (!res) {
+                if (error) { *error = xmlErr; (*error) += res.description(); }
+                return false;
+            }
+            out = frag.document_element();
+            return true;
+        };
+        auto is_payload = [](std::string_view n) {
+            return n == "BkToCstmrStmt" || n == "BkToCstmrDbtCdtNtfctn" || n == "BkToCstmrAcctRpt";
+        };
+
+        enum class Capture { None, GrpHdr, StmtChild, Ntry };
+        Capture cap = Capture::None;
+        int depth = 0;          // number of open elements
+        int captureDepth = -1;  // depth of the captured element
+        int payloadDepth = -1;
+        int stmtDepth = -1;
+        bool seenRoot = false;
+        std::vector<std::string> open;  // element names outside of captures
+
+        std::optional<GroupHeader> gh;
+        Statement header;
+        std::string stmtOpen, stmtQName, head, tail;
+        bool headerSent = false;
+        bool skipStmt = false;  // rejected by the filter: its children are not captured
+        int ordinal = 0;
+        const ParseFilter* filter = opt_.filter.empty() ? nullptr : &opt_.filter;
+        const bool entryFilter = filter && filter->filters_entries();
+
+        // Stmt start tag + collected children + end tag, as one small document
+        auto wrap = [&](const std::string& body) {
+            std::string xml = stmtOpen;
+            if (xml.size() >= 2 && xml[xml.size() - 2] == '/') xml.erase(xml.size() - 2, 1); // "<Stmt/>"
+            xml += body;
+            xml += "</"; xml += stmtQName; xml += '>';
+            return xml;
+        };
+        auto send_header = [&]() -> bool {
+            headerSent = true;
+            pugi::xml_node n;
+            if (!load(wrap(head), n)) return false;
+            skipStmt = !parse_statement(n, gh ? &*gh : nullptr, header, opt_.sections, filter);
+            if (!skipStmt) sink.on_statement(header);
+            return true;
+        };
+        auto end_statement = [&]() -> bool {
+            if (!headerSent && !send_header()) return false;
+            stmtDepth = -1;
+            if (skipStmt) return true;
+            if (!tail.empty() && (opt_.sections & SectionBalances)) {
+                pugi::xml_node n;
+                if (!load(wrap(tail), n)) return false;
+                for (pugi::xml_node b = n.first_child(); b; b = b.next_sibling())
+                    if (isln(b, "Bal")) header.balances.push_back(parse_balance(b));
+            }
+            sink.on_statement_end(header);
+            return true;
+        };
+        // 0 = continue, 1 = stopped by the sink, -1 = error
+        auto finish_capture = [&]() -> int {
+            const std::string_view xml = rd.capture(); // valid until the next token
+            const Capture c = cap;
+            cap = Capture::None;
+            captureDepth = -1;
+            rd.end_capture();
+
+            if (c == Capture::StmtChild) {
+                // children after the first entry are only scanned for balances
+                (headerSent ? tail : head).append(xml.data(), xml.size());
+                return 0;
+            }
+
+            pugi::xml_node n;
+            if (!load(xml, n)) return -1;
+            if (c == Capture::GrpHdr) {
+                gh = parse_group_header(n);
+                sink.on_group_header(*gh);
+                return 0;
+            }
+            if (entryFilter && !entry_matches(n, *filter)) {
+                ++ordinal;
+                return 0;
+            }
+            Entry e = parse_entry(n, &header.account.currency, opt_.sections);
+            e.importOrdinal = ordinal++;      // same ordinal as in parse_statement()
+            return sink.on_entry(header, std::move(e)) ? 0 : 1;
+        };
+
+        for (;;) {
+            const Token t = rd.next();
+            if (t == Token::Eof) break;
+            if (t == Token::Error) return fail(xmlErr + rd.error_message());
+            if (t == Token::Other) continue;
+
+            if (t == Token::EndTag) {
+                if (--depth < 0) return fail(std::string(xmlErr) + "Start-end tags mismatch");
+                if (cap == Capture::None) {
+                    // captured elements are checked by pugixml, everything else here
+                    if (open.empty() || open.back() != rd.qname())
+                        return fail(std::string(xmlErr) + "Start-end tags mismatch");
+                    open.pop_back();
+                    if (stmtDepth >= 0 && depth == stmtDepth && !end_statement()) return false;
+                } else if (depth == captureDepth) {
+                    const int r = finish_capture();
+                    if (r < 0) return false;
+                    if (r > 0) return true;
+                }
+                continue;
+            }
+
+            // StartTag / EmptyTag
+            seenRoot = true;
+            const bool empty = (t == Token::EmptyTag);
+            if (cap == Capture::None) {
+                const std::string_view name = rd.local_name();
+                if (payloadDepth < 0) {
+                    if (is_payload(name)) {
+                        payloadDepth = depth;
+                        if (name == "BkToCstmrStmt") sink.on_document(DocKind::Camt053);
+                        else if (name == "BkToCstmrDbtCdtNtfctn") sink.on_document(DocKind::Camt054);
+                        else sink.on_document(DocKind::Camt052);
+                    }
+                } else if (depth == payloadDepth + 1 && stmtDepth < 0) {
+                    if (name == "GrpHdr" && !gh) {
+                        cap = Capture::GrpHdr;
+                    } else if (name == "Stmt" || name == "Ntfctn" || name == "Rpt") {
+                        stmtOpen.assign(rd.token());
+                        stmtQName.assign(rd.qname());
+                        head.clear(); tail.clear();
+                        headerSent = false;
+                        skipStmt = false;
+                        ordinal = 0;
+                        stmtDepth = depth;
+                        if (empty && !end_statement()) return false;
+                    }
+                } else if (stmtDepth >= 0 && depth == stmtDepth + 1) {
+                    // the head is complete at the first entry
+                    if (name == "Ntry" && !headerSent && !send_header()) return false;
+                    if (!skipStmt) cap = (name == "Ntry") ? Capture::Ntry : Capture::StmtChild;
+                }
+                if (cap != Capture::None) {
+                    rd.begin_capture();
+                    captureDepth = depth;
+                    if (empty) {
+                        const int r = finish_capture();
+                        if (r < 0) return false;
+                        if (r > 0) return true;
+                        continue;
+                    }
+                }
+            }
+            if (!empty) {
+                if (cap == Capture::None) open.emplace_back(rd.qname());
+                ++depth;
+            }
         }
-        pugi::xml_node payload = find_payload(root);
-        out.kind = detect_kind(payload);
-        if (out.kind==DocKind::Unknown)
+
+        if (!seenRoot) return fail(std::string(xmlErr) + "No document element found");
+        if (depth != 0) return fail(std::string(xmlErr) + "Start-end tags mismatch");
+        if (payloadDepth < 0) return fail("Unsupported CAMT root");
+        return true;
+    }
+
+private:
+    static bool fail_with(std::string* error, const std::string& msg) {
+        if (error) *error = msg;
+        return false;
+    }
+
+    // from the first byte: XML cannot start with 0x1F (gzip) or 'P' (ZIP)
+    static Compression peek_compression(std::istream& is) {
+        std::streambuf* sb = is.rdbuf();
+        const int c = sb ? sb->sgetc() : std::char_traits<char>::eof();
+        if (c == 0x1F) return Compression::Gzip;
+        if (c == 'P') return Compression::Zip;
+        return Compression::None;
+    }
+
+    // DOM over data (modified), then parse_doc()
+    bool parse_inplace(char* data, std::size_t size, Document& out, std::string* error) const {
+        const Compression c = detect_compression(data, size);
+        if (c != Compression::None) return parse_compressed(data, size, c, out, error);
+        CAMT_STAT_TIMER(load, opt_.stats, Load);
+        pugi::xml_document doc;
+        pugi::xml_parse_result res = doc.load_buffer_inplace(data, size, pugi::parse_default | pugi::parse_declaration);
+        CAMT_STAT_STOP(load);
+        if (!res)
         {
             if(error)
             {
-                *error="Unsupported CAMT root";
+                *error=xmlErr;
+                (*error) += res.description();
             }
             return false;
         }
+        return parse_doc(doc, out, error);
+    }
 
-        // optional GrpHdr above the statements
-        std::optional<GroupHeader> gh;
-        pugi::xml_node g = child_any(payload,"GrpHdr");
-        if (g)
-        {
-            gh = parse_group_header(g);
+    // gzip: one document; ZIP: the .xml members in archive order, their
+    // statements appended to out
+    bool parse_compressed(const char* data, std::size_t size, Compression c, Document& out, std::string* error) const {
+        std::string xml;
+        if (c == Compression::Gzip) {
+            CAMT_STAT_TIMER(inflate, opt_.stats, Load);
+            if (!gunzip(data, size, xml, error)) return false;
+            CAMT_STAT_STOP(inflate);
+            return parse_inplace(&xml[0], xml.size(), out, error);
         }
-
-        for (pugi::xml_node n = payload.first_child(); n; n = n.next_sibling()){
-            if (isln(n,"Stmt") || isln(n,"Ntfctn") || isln(n,"Rpt"))
-                out.statements.push_back(parse_statement(n, gh ? &*gh : nullptr));
+        ZipArchive zip;
+        if (!zip.open_buffer(data, size, error)) return false;
+        bool any = false;
+        for (std::size_t i = 0; i < zip.size(); ++i) {
+            const ZipMember& m = zip.members()[i];
+            if (m.is_directory() || !has_extension(m.name, ".xml")) continue;
+            CAMT_STAT_TIMER(inflate, opt_.stats, Load);
+            if (!zip.extract(i, xml, error)) return false;
+            CAMT_STAT_STOP(inflate);
+            std::string msg;
+            if (!parse_inplace(&xml[0], xml.size(), out, &msg)) return fail_with(error, "'" + m.name + "': " + msg);
+            any = true;
         }
+        if (!any) return fail_with(error, "ZIP archive contains no .xml member");
         return true;
     }
 
+    bool parse_doc(const pugi::xml_document& doc, Document& out, std::string* error) const {
+        const std::size_t first = out.statements.size();
+        CAMT_STAT_TIMER(map, opt_.stats, Map);
+        const bool ok = parse_document(doc, out, first, error, &opt_);
+        CAMT_STAT_STOP(map);
+#ifdef CAMT_STATS
+        if (Stats* st = opt_.stats) {
+            walk_desc(doc, [&](const pugi::xml_node& n) {
+                st->xmlNodes += n.type() == pugi::node_element;
+                return true;
+            });
+            for (std::size_t i = first; i < out.statements.size(); ++i) {
+                ++st->statements;
+                st->entries += out.statements[i].entries.size();
+                for (const Entry& e : out.statements[i].entries) st->transactions += e.transactions.size();
+            }
+        }
+#endif
+        return ok;
+    }
+
+    ParseOptions opt_;
     const char* xmlErr="XML file parse error: ";
 };
 
@@ -0,0 +1,396 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_csv.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace camt {
+
+// ---------- Pipelined parse and export ----------
+// Pipeline::run() streams a document from XML to CSV in three stages that
+// overlap instead of running one after the other:
+//
+//   parse thread    reading + tokenizing + mapping (Parser::parse_stream()),
+//                   entries are grouped into batches of batchEntries
+//   row thread      export_entries_csv() of every batch into a CSV block
+//   calling thread  writes the blocks to the output stream
+//
+// The stages are connected by bounded lock-free queues (SpscQueue); a full
+// queue blocks its producer, so memory stays at about queueDepth batches per
+// stage however large the input. Batches are processed in input order and the
+// CSV is the same as export_entries_csv() of the whole document (see below),
+// so the run time approaches that of the slowest stage.
+//
+//   camt::Pipeline pipe(parseOpt, exportOpt);
+//   std::ofstream out("out.csv", std::ios::binary);
+//   if (!pipe.run_file("big.xml", out, &err)) { /* ... */ }
+//
+// A statement split over several batches gets its global OpeningBalance on
+// its first and ClosingBalance on its last row as usual, and RunningBalance
+// continues over the batches. Interim balances (ITBD/ITAV) that follow the
+// entries in the XML (non-standard) reach only the last batch of a statement.
+//
+// ExportOptions::row_filter and running_balance_start are called on the row
+// thread; running_balance_start once per statement. The parse and export
+// Stats must be different objects (ParseOptions::stats / ExportOptions::stats).
+// On failure the output may already hold the rows before the error.
+
+namespace detail {
+// spin briefly, then yield, then sleep: a waiting stage gives its core back
+class Backoff {
+public:
+    void pause()
+    {
+        if (n_ < 64) {
+            ++n_;
+        } else if (n_ < 128) {
+            ++n_;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+private:
+    unsigned n_ = 0;
+};
+
+// appends everything written to the stream to *target
+class StringAppendBuf : public std::streambuf {
+public:
+    void target(std::string* s) { s_ = s; }
+
+protected:
+    std::streamsize xsputn(const char* data, std::streamsize n) override
+    {
+        s_->append(data, (std::size_t)n);
+        return n;
+    }
+    int overflow(int c) override
+    {
+        if (c != traits_type::eof()) s_->push_back((char)c);
+        return traits_type::not_eof(c);
+    }
+
+private:
+    std::string* s_ = nullptr;
+};
+} // namespace detail
+
+// Bounded ring buffer for exactly one producer and one consumer thread.
+// Lock-free: head and tail are atomics on separate cache lines, each side
+// keeps a cached copy of the other's index and only reloads it when the ring
+// looks full (producer) or empty (consumer). close() releases both sides.
+template<class T>
+class SpscQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscQueue(std::size_t capacity)
+    {
+        std::size_t n = 2;
+        while (n < capacity) n <<= 1;
+        slots_.resize(n);
+        mask_ = n - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // v is moved from only on success
+    bool try_push(T& v)
+    {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - headCache_ == slots_.size()) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (t - headCache_ == slots_.size()) return false;
+        }
+        slots_[t & mask_] = std::move(v);
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& v)
+    {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tailCache_) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (h == tailCache_) return false;
+        }
+        v = std::move(slots_[h & mask_]);
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // waits while the queue is full; false if it was closed
+    bool push(T&& v)
+    {
+        detail::Backoff b;
+        while (!try_push(v)) {
+            if (closed()) return false;
+            b.pause();
+        }
+        return true;
+    }
+
+    // waits while the queue is empty; false once it is closed and drained
+    bool pop(T& v)
+    {
+        detail::Backoff b;
+        while (!try_pop(v)) {
+            if (closed()) return try_pop(v);
+            b.pause();
+        }
+        return true;
+    }
+
+    // no more items (producer) or no more interest in them (consumer)
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> head_{0};  // next slot to pop
+    std::size_t tailCache_ = 0;                     // consumer's copy of tail_
+    alignas(64) std::atomic<std::size_t> tail_{0};  // next slot to push
+    std::size_t headCache_ = 0;                     // producer's copy of head_
+    alignas(64) std::atomic<bool> closed_{false};
+};
+
+struct PipelineOptions {
+    std::size_t batchEntries = 1024;     // entries per batch between parse and row stage
+    std::size_t queueDepth = 8;          // batches / CSV blocks in flight per queue
+    std::size_t chunkSize = 64 * 1024;   // read size of the streaming parser
+};
+
+class Pipeline {
+public:
+    Pipeline() = default;
+    explicit Pipeline(const ParseOptions& parseOpt, const ExportOptions& exportOpt = {},
+                      const PipelineOptions& opt = {})
+        : parser_(parseOpt), exportOpt_(exportOpt), opt_(opt) {}
+
+    const PipelineOptions& options() const { return opt_; }
+    const ExportOptions& export_options() const { return exportOpt_; }
+
+    // parses in and writes the CSV of all entries to out
+    bool run(std::istream& in, std::ostream& out, std::string* error = nullptr) const
+    {
+        SpscQueue<Batch> batches(opt_.queueDepth);
+        SpscQueue<std::string> blocks(opt_.queueDepth);
+        std::atomic<bool> cancel{false};
+        std::string parseError;
+        bool parsed = false;
+        std::exception_ptr parseEx, rowEx;
+
+        std::thread parseThread([&] {
+            try {
+                BatchSink sink(batches, cancel, opt_.batchEntries);
+                parsed = parser_.parse_stream(in, sink, &parseError, opt_.chunkSize);
+            } catch (...) {
+                parseEx = std::current_exception();
+                cancel.store(true);
+            }
+            batches.close();
+        });
+        std::thread rowThread([&] {
+            try {
+                build_rows(batches, blocks);
+            } catch (...) {
+                rowEx = std::current_exception();
+                cancel.store(true);
+                batches.close(); // releases the parse thread
+            }
+            blocks.close();
+        });
+
+        bool written = true;
+        std::string block;
+        while (blocks.pop(block)) {
+            out.write(block.data(), (std::streamsize)block.size());
+            if (!out) {
+                written = false;
+                cancel.store(true);
+                blocks.close();
+                batches.close();
+                break;
+            }
+        }
+        rowThread.join();
+        parseThread.join();
+
+        if (parseEx) std::rethrow_exception(parseEx);
+        if (rowEx) std::rethrow_exception(rowEx);
+        // a write failure cancels the parse, so it is checked first
+        if (!written) {
+            if (error) *error = "Write failed";
+            return false;
+        }
+        if (!parsed) {
+            if (error) *error = parseError;
+            return false;
+        }
+        return true;
+    }
+
+    bool run_file(const std::string& utf8Path, std::ostream& out, std::string* error = nullptr) const
+    {
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if (!check_input_file(p, utf8Path, error)) {
+            return false;
+        }
+        errno = 0;
+        std::ifstream in(p, std::ios::binary);
+        if (!in.is_open()) {
+            const int e = errno;
+            if (error) {
+                *error = std::string("Open failed for '") + utf8Path + "': "
+                       + (e ? std::system_category().message(e) : std::string("unknown error"));
+            }
+            return false;
+        }
+        return run(in, out, error);
+    }
+
+private:
+    // consecutive entries of one statement
+    struct Batch {
+        DocKind kind = DocKind::Unknown;
+        std::shared_ptr<const Statement> header;
+        std::vector<Entry> entries;
+        bool first = false;  // starts the statement
+        bool last = false;   // ends it (header incl. trailing balances)
+    };
+
+    // parse stage: a full batch is held back until the next entry shows it
+    // is not the statement's last one
+    class BatchSink : public EntrySink {
+    public:
+        BatchSink(SpscQueue<Batch>& q, std::atomic<bool>& cancel, std::size_t batchEntries)
+            : q_(q), cancel_(cancel), size_(batchEntries ? batchEntries : 1) {}
+
+        void on_document(DocKind kind) override { kind_ = kind; }
+
+        void on_statement(const Statement& header) override
+        {
+            header_ = std::make_shared<const Statement>(header);
+            first_ = true;
+            pending_.reserve(size_);
+        }
+
+        bool on_entry(const Statement&, Entry&& entry) override
+        {
+            if (pending_.size() >= size_ && !flush(false)) return false;
+            pending_.push_back(std::move(entry));
+            return !cancel_.load(std::memory_order_relaxed);
+        }
+
+        void on_statement_end(const Statement& header) override
+        {
+            header_ = std::make_shared<const Statement>(header);
+            flush(true);
+        }
+
+    private:
+        bool flush(bool last)
+        {
+            Batch b;
+            b.kind = kind_;
+            b.header = header_;
+            b.entries.swap(pending_);
+            b.first = first_;
+            b.last = last;
+            first_ = false;
+            if (!last) pending_.reserve(size_);
+            return q_.push(std::move(b));
+        }
+
+        SpscQueue<Batch>& q_;
+        std::atomic<bool>& cancel_;
+        std::size_t size_;
+        DocKind kind_ = DocKind::Unknown;
+        std::shared_ptr<const Statement> header_;
+        std::vector<Entry> pending_;
+        bool first_ = false;
+    };
+
+    // row stage: one export per batch, the header row only before the first
+    void build_rows(SpscQueue<Batch>& batches, SpscQueue<std::string>& blocks) const
+    {
+        std::int64_t running = 0;
+        ExportOptions o = exportOpt_;
+        o.running_balance_start = [&running](const Statement&) { return running; };
+
+        Document doc;
+        doc.statements.resize(1);
+        Statement& st = doc.statements[0];
+        detail::StringAppendBuf buf;
+        std::ostream os(&buf);
+        std::string block;
+
+        auto export_block = [&](const Document& d) {
+            block.clear();
+            buf.target(&block);
+            export_entries_csv(d, &os, nullptr, o);
+            o.include_header = false;
+            o.write_utf8_bom = false;
+            return block.empty() || blocks.push(std::move(block));
+        };
+
+        Batch b;
+        while (batches.pop(b)) {
+            if (b.entries.empty()) continue;
+            st = *b.header;
+            st.entries = std::move(b.entries);
+            doc.kind = b.kind;
+            if (b.first) {
+                running = exportOpt_.running_balance_start ? exportOpt_.running_balance_start(st) : 0;
+                o.running_balance_currency = exportOpt_.running_balance_currency;
+            }
+            o.statement_starts = b.first;
+            o.statement_ends = b.last;
+            if (!export_block(doc)) return;
+            for (const auto& e : st.entries) {
+                running += detail::running_contribution(e);
+                // the currency the export took from the first row with one
+                if (st.account.currency.empty() && o.running_balance_currency.empty()) {
+                    const EntryTransaction* tx = e.transactions.empty() ? nullptr : &e.transactions.front();
+                    const std::string& c = (tx && tx->txAmount.has_value()) ? tx->txAmount->currency : e.amount.currency;
+                    o.running_balance_currency = !c.empty() ? c : e.amount.currency;
+                }
+            }
+        }
+        // no rows at all: header row / BOM, as export_entries_csv() writes them
+        if ((o.include_header || o.write_utf8_bom) && !blocks.closed()) export_block(Document());
+    }
+
+    Parser parser_;
+    ExportOptions exportOpt_;
+    PipelineOptions opt_;
+};
+
+} // namespace camt
@@ -0,0 +1,171 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_parser_pugi.hpp"
+#include <string>
+#include <vector>
+#include <istream>
+#include <fstream>
+#include <cerrno>
+#include <system_error>
+#include <filesystem>
+
+namespace camt {
+
+// ---------- ParserSession ----------
+// Parser state that is kept alive between parses, for batch jobs that import
+// many files in a row: the input buffer, the pugi::xml_document and the
+// resulting Document. The input is read into the same buffer and parsed in
+// place, and the model is overwritten field by field (parse_xxx(node, out)),
+// so strings and vectors keep their capacity. Once warmed up to the largest
+// input, a parse only allocates for strings that outgrow their buffer and for
+// the node pages of pugixml (freed by the DOM on every load).
+//
+// gzip input is inflated in memory into a second reused buffer; a ZIP archive
+// is rejected (extract its members with ZipArchive::extract()).
+//
+// Not thread-safe: use one session per thread. document() is valid until the
+// next parse call; on failure it is empty (kind Unknown, no statements).
+class ParserSession {
+public:
+    ParserSession() = default;
+    explicit ParserSession(const ParseOptions& opt) : opt_(opt) {}
+
+    bool parse_file(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if (!check_input_file(p, utf8Path, error)) {
+            return fail();
+        }
+
+        errno = 0;
+        std::ifstream in(p, std::ios::binary);
+        if (!in.is_open()) {
+            const int e = errno; // must read immediately
+            const std::string sysMsg = std::system_category().message(e);
+            if (error) {
+                *error = std::string("Open failed for '") + utf8Path + "': "
+                       + (e ? sysMsg : std::string("unknown error"));
+            }
+            return fail();
+        }
+
+        // one read() for the whole file (+1 so that EOF is hit in the same call)
+        std::error_code ec;
+        const std::uintmax_t sz = std::filesystem::file_size(p, ec);
+        if (!ec) reserve((std::size_t)sz + 1);
+
+        return read_and_load(in, error);
+    }
+
+    bool parse_file(std::istream& is, std::string* error = nullptr)
+    {
+        return read_and_load(is, error);
+    }
+
+    bool parse_string(const std::string& xml_utf8, std::string* error = nullptr)
+    {
+        return parse_buffer(xml_utf8.data(), xml_utf8.size(), error);
+    }
+
+    // the data is copied into the session buffer (parsing happens in place)
+    bool parse_buffer(const char* data, std::size_t size, std::string* error = nullptr)
+    {
+        reserve(size);
+        if (size) std::memcpy(buf_.data(), data, size);
+        return load(size, error);
+    }
+
+    const Document& document() const { return doc_; }
+    Document& document() { return doc_; }
+
+    // frees the buffers held by the session
+    void release()
+    {
+        dom_.reset();
+        std::vector<char>().swap(buf_);
+        std::string().swap(inflated_);
+        doc_ = Document();
+    }
+
+private:
+    void reserve(std::size_t n)
+    {
+        if (buf_.size() < n) buf_.resize(n);
+    }
+
+    bool read_and_load(std::istream& is, std::string* error)
+    {
+        std::size_t len = 0;
+        for (;;) {
+            if (buf_.size() - len < 4096) reserve(std::max<std::size_t>(64 * 1024, buf_.size() * 2));
+            is.read(buf_.data() + len, (std::streamsize)(buf_.size() - len));
+            len += (std::size_t)is.gcount();
+            if (!is) break;
+        }
+        if (is.bad()) {
+            if (error) {
+                *error = std::string(xmlErr) + "I/O error";
+            }
+            return fail();
+        }
+        return load(len, error);
+    }
+
+    bool load(std::size_t size, std::string* error)
+    {
+        char* data = buf_.data();
+        switch (detect_compression(data, size)) {
+        case Compression::Gzip:
+            if (!gunzip(data, size, inflated_, error)) return fail();
+            data = inflated_.data();
+            size = inflated_.size();
+            break;
+        case Compression::Zip:
+            if (error) *error = detail::zip_unsupported_message();
+            return fail();
+        case Compression::None:
+            break;
+        }
+
+        pugi::xml_parse_result res = dom_.load_buffer_inplace(data, size, pugi::parse_default | pugi::parse_declaration);
+        if (!res)
+        {
+            if(error)
+            {
+                *error=xmlErr;
+                (*error) += res.description();
+            }
+            return fail();
+        }
+        if (!parse_document(dom_, doc_, 0, error, &opt_)) {
+            return fail();
+        }
+        return true;
+    }
+
+    bool fail()
+    {
+        doc_.kind = DocKind::Unknown;
+        doc_.statements.clear();
+        return false;
+    }
+
+    std::vector<char> buf_;        // input, parsed in place (never shrinks)
+    std::string inflated_;         // gzip input inflated, parsed in place
+    pugi::xml_document dom_;
+    Document doc_;
+    ParseOptions opt_;
+
+    const char* xmlErr="XML file parse error: ";
+};
+
+} // namespace camt
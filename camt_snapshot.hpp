@@ -0,0 +1,417 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_view.hpp"
+#include "camt_fingerprint.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace camt {
+
+// ---------- Binary snapshots ----------
+// A parsed document in a compact binary file, to re-open archived statements
+// without parsing XML again. The file is little-endian and versioned:
+//
+//   header (64 bytes)   magic "CAMTSNP1", version, DocKind, statement count,
+//                       offsets of the statement index and the string pool
+//   records             per statement its fields, balances and entries, and
+//                       per entry its transactions, in document order
+//   statement index     u64 file offset of every statement record
+//   string pool         every distinct string once, records refer to it
+//                       by (u32 offset, u32 length)
+//
+// load_snapshot() maps the file and binds a DocumentView to it. The strings
+// are string_views into the mapped pool; the records are decoded into view
+// structs in the arena, in one linear pass with no text to parse.
+//
+//   save_snapshot(doc, "2025-03.camtsnap", &err);   // Document or DocumentView
+//   DocumentView v;
+//   load_snapshot("2025-03.camtsnap", v, &err);     // v.statements[...] as after parse_file()
+
+namespace detail {
+
+constexpr char kSnapshotMagic[8] = {'C', 'A', 'M', 'T', 'S', 'N', 'P', '1'};
+constexpr std::uint32_t kSnapshotVersion = 1;
+constexpr std::size_t kSnapshotHeaderSize = 64;
+
+// Record encoder. The field lists below are templates that take either
+// archive, so the writer and the reader cannot disagree on the layout.
+// str() keeps views of the strings it interns: the document must outlive
+// the writer.
+class SnapshotWriter {
+public:
+    std::string out;   // header + records
+    std::string pool;
+
+    void u8(bool v) { out.push_back(v ? '\1' : '\0'); }
+    void u32(std::uint32_t v) { for (int i = 0; i < 4; ++i) out.push_back((char)(v >> (8 * i))); }
+    void u64(std::uint64_t v) { for (int i = 0; i < 8; ++i) out.push_back((char)(v >> (8 * i))); }
+    void i32(int v) { u32((std::uint32_t)v); }
+    void i64(std::int64_t v) { u64((std::uint64_t)v); }
+    void f64(double v)
+    {
+        std::uint64_t b;
+        std::memcpy(&b, &v, sizeof(b));
+        u64(b);
+    }
+    void str(std::string_view s)
+    {
+        if (s.empty()) { u32(0); u32(0); return; }
+        auto it = interned_.emplace(s, (std::uint32_t)pool.size());
+        if (it.second) pool.append(s.data(), s.size());
+        u32(it.first->second);
+        u32((std::uint32_t)s.size());
+    }
+    // f(archive, element): the element layout, the same for both archives
+    template <class V, class F>
+    void array(const V& v, F&& f)
+    {
+        u32((std::uint32_t)v.size());
+        for (const auto& x : v) f(*this, x);
+    }
+    template <class O, class F>
+    void optional(const O& o, F&& f)
+    {
+        u8(o.has_value());
+        if (o) f(*o);
+    }
+
+private:
+    std::unordered_map<std::string_view, std::uint32_t> interned_;
+};
+
+// bytes of a default (empty) T under layout f: the least any T takes
+template <class T, class F>
+inline std::size_t encoded_min_size(F& f)
+{
+    static const std::size_t n = [&] {
+        SnapshotWriter w;
+        T x{};
+        f(w, x);
+        return std::max<std::size_t>(1, w.out.size());
+    }();
+    return n;
+}
+
+// Record decoder over a mapped file; every read is bounds-checked, and after
+// the first failure ok is false and all reads return zeros.
+class SnapshotReader {
+public:
+    SnapshotReader(const char* data, std::size_t size, const char* pool, std::size_t poolSize)
+        : p_(data), e_(data + size), pool_(pool), poolSize_(poolSize) {}
+
+    bool ok = true;
+
+    void seek(const char* p) { p_ = p; }
+    void u8(bool& v) { v = take(1) && p_[-1] != 0; }
+    void u32(std::uint32_t& v) { v = (std::uint32_t)load(4); }
+    void u64(std::uint64_t& v) { v = load(8); }
+    void i32(int& v) { v = (int)(std::uint32_t)load(4); }
+    void i64(std::int64_t& v) { v = (std::int64_t)load(8); }
+    void f64(double& v)
+    {
+        const std::uint64_t b = load(8);
+        std::memcpy(&v, &b, sizeof(v));
+    }
+    void str(std::string_view& s)
+    {
+        const std::uint64_t off = load(4), len = load(4);
+        if (off + len > poolSize_) { ok = false; s = std::string_view(); return; }
+        s = std::string_view(pool_ + off, (std::size_t)len);
+    }
+    template <class V, class F>
+    void array(V& v, F&& f)
+    {
+        const std::uint64_t n = load(4);
+        // every element takes at least its empty encoding, so a small file
+        // cannot make us allocate many large view structs
+        if (n > (std::uint64_t)(e_ - p_) / encoded_min_size<typename V::value_type>(f)) { ok = false; return; }
+        v.resize((std::size_t)n);
+        for (auto& x : v) {
+            f(*this, x);
+            if (!ok) return;
+        }
+    }
+    template <class O, class F>
+    void optional(O& o, F&& f)
+    {
+        bool has = false;
+        u8(has);
+        if (has) f(o.emplace());
+    }
+
+private:
+    bool take(std::size_t n)
+    {
+        if (!ok || (std::size_t)(e_ - p_) < n) { ok = false; return false; }
+        p_ += n;
+        return true;
+    }
+    std::uint64_t load(int n)
+    {
+        if (!take((std::size_t)n)) return 0;
+        std::uint64_t v = 0;
+        for (int i = n - 1; i >= 0; --i) v = (v << 8) | (unsigned char)p_[i - n];
+        return v;
+    }
+
+    const char* p_;
+    const char* e_;
+    const char* pool_;
+    std::size_t poolSize_;
+};
+
+// ---------- Record layout (shared by writer and reader) ----------
+template <class A, class T> void snap_amount(A& a, T& x) { a.str(x.currency); a.i64(x.minor); }
+template <class A, class T> void snap_account_id(A& a, T& x) { a.str(x.iban); a.str(x.other); }
+template <class A, class T> void snap_agent(A& a, T& x) { a.str(x.bic); a.str(x.name); }
+template <class A, class T> void snap_party(A& a, T& x) { a.str(x.name); a.str(x.iban); a.str(x.bic); }
+
+template <class A, class T>
+void snap_transaction(A& a, T& t)
+{
+    a.str(t.refs.endToEndId); a.str(t.refs.txId); a.str(t.refs.acctSvcrRef);
+    a.str(t.refs.mandateId); a.str(t.refs.msgId);
+    snap_party(a, t.parties.debtor); snap_account_id(a, t.parties.debtorAccount);
+    snap_party(a, t.parties.ultimateDebtor);
+    snap_party(a, t.parties.creditor); snap_account_id(a, t.parties.creditorAccount);
+    snap_party(a, t.parties.ultimateCreditor);
+    snap_agent(a, t.agents.debtorAgent); snap_agent(a, t.agents.creditorAgent);
+    a.array(t.remittance.unstructured, [](auto& ar, auto& s) { ar.str(s); });
+    a.array(t.remittance.structured, [](auto& ar, auto& s) {
+        ar.str(s.creditorRefType); ar.str(s.creditorRef); ar.str(s.additionalInfo);
+    });
+    a.str(t.purpose.code); a.str(t.purpose.proprietary);
+    a.str(t.bankTxCode.domain); a.str(t.bankTxCode.family);
+    a.str(t.bankTxCode.subFamily); a.str(t.bankTxCode.proprietary);
+    a.str(t.proprietaryBankTxCode.code); a.str(t.proprietaryBankTxCode.issuer);
+    snap_amount(a, t.charges.total);
+    a.array(t.charges.records, [](auto& ar, auto& r) {
+        snap_amount(ar, r.amount); snap_agent(ar, r.agent);
+        ar.u8(r.hasCdtDbtInd); ar.u8(r.isCredit); ar.u8(r.included);
+    });
+    a.str(t.additionalInfo);
+    a.optional(t.txAmount, [&](auto& m) { snap_amount(a, m); });
+    a.str(t.dtaCode); a.str(t.gvc);
+    a.u8(t.hasCdtDbtInd); a.u8(t.isCredit);
+    a.str(t.codeSwift);
+    a.str(t.fx.srcCcy); a.str(t.fx.trgtCcy); a.str(t.fx.unitCcy); a.f64(t.fx.rate); a.u8(t.fx.has);
+    snap_amount(a, t.fxInstdAmt); snap_amount(a, t.fxTxAmt); snap_amount(a, t.fxCounterValAmt);
+    a.u8(t.hasFxInstdAmt); a.u8(t.hasFxTxAmt); a.u8(t.hasFxCntrVal);
+    a.i32(t.importOrdinal);
+}
+
+template <class A, class T>
+void snap_entry(A& a, T& e)
+{
+    snap_amount(a, e.amount);
+    a.u8(e.isCredit);
+    a.str(e.bookingDate); a.str(e.valueDate);
+    a.i32(e.bookingDateInt); a.i32(e.valueDateInt);
+    a.str(e.entryRef);
+    a.array(e.transactions, [](auto& ar, auto& t) { snap_transaction(ar, t); });
+    a.u8(e.reversal);
+    a.str(e.status); a.str(e.acctSvcrRef);
+    a.i32(e.importOrdinal);
+}
+
+template <class A, class T>
+void snap_statement(A& a, T& s)
+{
+    a.str(s.id); a.str(s.creationDateTime);
+    snap_account_id(a, s.account.id); a.str(s.account.name); a.str(s.account.currency);
+    snap_agent(a, s.account.servicer);
+    a.str(s.groupHeader.msgId); a.str(s.groupHeader.creationDateTime); a.str(s.groupHeader.messageRecipient);
+    a.array(s.balances, [](auto& ar, auto& b) {
+        ar.str(b.type); snap_amount(ar, b.amount); ar.str(b.date); ar.u8(b.hasCdtDbtInd); ar.u8(b.isCredit);
+    });
+    a.array(s.entries, [](auto& ar, auto& e) { snap_entry(ar, e); });
+}
+
+inline bool write_file_atomic(const std::filesystem::path& p, const std::string& a, const std::string& b, std::string* error)
+{
+    std::filesystem::path tmp = p;
+    tmp += ".tmp";
+    errno = 0;
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (out.is_open()) {
+            out.write(a.data(), (std::streamsize)a.size());
+            out.write(b.data(), (std::streamsize)b.size());
+            out.flush();
+        }
+        if (!out) {
+            const int e = errno;
+            if (error) {
+                *error = std::string("Write failed for '") + tmp.u8string() + "': "
+                       + (e ? std::system_category().message(e) : std::string("unknown error"));
+            }
+            std::error_code rmEc;
+            std::filesystem::remove(tmp, rmEc);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, p, ec);
+    if (ec) {
+        if (error) *error = std::string("Rename failed for '") + p.u8string() + "': " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+struct SnapshotAccess {
+    static bool load(const std::filesystem::path& p, const std::string& utf8Path, DocumentView& out, std::string* error)
+    {
+        out.reset();
+        std::string sysMsg;
+        if (!out.map_.open(p, &sysMsg)) {
+            if (error) *error = std::string("Open failed for '") + utf8Path + "': " + sysMsg;
+            return false;
+        }
+        const char* data = out.map_.data();
+        const std::size_t size = out.map_.size();
+        auto invalid = [&]() {
+            out.reset();
+            if (error) *error = std::string("Not a valid snapshot: '") + utf8Path + "'";
+            return false;
+        };
+        if (size < kSnapshotHeaderSize || std::memcmp(data, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0)
+            return invalid();
+
+        auto statementLayout = [](auto& ar, auto& st) { snap_statement(ar, st); };
+        SnapshotReader h(data + sizeof(kSnapshotMagic), kSnapshotHeaderSize - sizeof(kSnapshotMagic), nullptr, 0);
+        std::uint32_t version = 0, kind = 0, count = 0, reserved = 0;
+        std::uint64_t indexOff = 0, poolOff = 0, poolSize = 0, fileSize = 0;
+        h.u32(version); h.u32(kind); h.u32(count); h.u32(reserved);
+        h.u64(indexOff); h.u64(poolOff); h.u64(poolSize); h.u64(fileSize);
+        if (version != kSnapshotVersion) {
+            out.reset();
+            if (error) *error = std::string("Unsupported snapshot version in '") + utf8Path + "'";
+            return false;
+        }
+        if (!h.ok || fileSize != size || kind > (std::uint32_t)DocKind::Unknown
+            || poolOff > size || poolSize != size - poolOff
+            || indexOff < kSnapshotHeaderSize || indexOff > poolOff || count > (poolOff - indexOff) / 8
+            || count > (indexOff - kSnapshotHeaderSize) / encoded_min_size<StatementView>(statementLayout))
+            return invalid();
+
+        // the views take about twice the size of the records
+        out.arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(std::max<std::size_t>(4096, (std::size_t)poolOff * 2));
+        out.statements = ArenaVector<StatementView>(out.arena_.get());
+        out.statements.resize(count);
+
+        SnapshotReader r(data, (std::size_t)indexOff, data + poolOff, (std::size_t)poolSize);
+        SnapshotReader index(data + (std::size_t)indexOff, 8ull * count, nullptr, 0);
+        for (StatementView& st : out.statements) {
+            std::uint64_t off = 0;
+            index.u64(off);
+            if (off < kSnapshotHeaderSize || off >= indexOff) return invalid();
+            r.seek(data + off);
+            snap_statement(r, st);
+            if (!r.ok) return invalid();
+        }
+        out.kind = static_cast<DocKind>(kind);
+        return true;
+    }
+};
+
+} // namespace detail
+
+// Writes a Document (or a DocumentView) as a snapshot, via utf8Path.tmp and
+// a rename. Fails for documents with more than 4 GiB of distinct strings.
+template <class Doc>
+inline bool save_snapshot(const Doc& doc, const std::string& utf8Path, std::string* error = nullptr)
+{
+    detail::SnapshotWriter w;
+    w.out.assign(detail::kSnapshotHeaderSize, '\0');
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(doc.statements.size());
+    for (const auto& st : doc.statements) {
+        offsets.push_back(w.out.size());
+        detail::snap_statement(w, st);
+    }
+    if (w.pool.size() > 0xFFFFFFFFull) {
+        if (error) *error = std::string("Snapshot string pool too large for '") + utf8Path + "'";
+        return false;
+    }
+    const std::uint64_t indexOff = w.out.size();
+    for (std::uint64_t off : offsets) w.u64(off);
+    const std::uint64_t poolOff = w.out.size();
+
+    detail::SnapshotWriter h;
+    h.out.assign(detail::kSnapshotMagic, sizeof(detail::kSnapshotMagic));
+    h.u32(detail::kSnapshotVersion);
+    h.u32((std::uint32_t)doc.kind);
+    h.u32((std::uint32_t)offsets.size());
+    h.u32(0);
+    h.u64(indexOff);
+    h.u64(poolOff);
+    h.u64(w.pool.size());
+    h.u64(poolOff + w.pool.size());
+    std::memcpy(&w.out[0], h.out.data(), h.out.size()); // 56 of the 64 header bytes
+
+    return detail::write_file_atomic(std::filesystem::u8path(utf8Path), w.out, w.pool, error);
+}
+
+// Maps a snapshot and binds out to it (see above); out keeps the mapping
+// until its next parse or load. On failure out is empty.
+inline bool load_snapshot(const std::string& utf8Path, DocumentView& out, std::string* error = nullptr)
+{
+    const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+    if (!check_input_file(p, utf8Path, error)) {
+        return false;
+    }
+    return detail::SnapshotAccess::load(p, utf8Path, out, error);
+}
+
+// Snapshot cache for XML files: the key is the SipHash-128 of the file's
+// bytes, so a changed file never hits a stale entry. Loads
+// cacheDir/<key>.camtsnap if present, else parses the XML and writes the
+// snapshot (a failed cache write is not an error).
+inline bool load_cached(const std::string& xmlUtf8Path, const std::string& cacheDirUtf8, DocumentView& out, std::string* error = nullptr)
+{
+    std::string key;
+    {
+        const std::filesystem::path p = std::filesystem::u8path(xmlUtf8Path);
+        if (!check_input_file(p, xmlUtf8Path, error)) {
+            return false;
+        }
+        MappedFile m;
+        std::string sysMsg;
+        if (!m.open(p, &sysMsg)) {
+            if (error) *error = std::string("Open failed for '") + xmlUtf8Path + "': " + sysMsg;
+            return false;
+        }
+        key = SipHasher128().update(m.data(), m.size()).finish().hex();
+    }
+    const std::string snap = (std::filesystem::u8path(cacheDirUtf8) / (key + ".camtsnap")).u8string();
+
+    std::error_code ec;
+    if (std::filesystem::exists(std::filesystem::u8path(snap), ec) && load_snapshot(snap, out)) {
+        return true;
+    }
+    if (!out.parse_file(xmlUtf8Path, error)) {
+        return false;
+    }
+    save_snapshot(out, snap);
+    return true;
+}
+
+} // namespace camt
@@ -0,0 +1,163 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace camt {
+
+// ---------- Instrumentation ----------
+// Counters and per-phase times of parse and export runs, filled in when
+// ParseOptions::stats / ExportOptions::stats point to a Stats object. The
+// hooks are compiled in only with CAMT_STATS defined (DEFINES += CAMT_STATS);
+// without it the CAMT_STAT_* macros expand to nothing and the stats pointers
+// are ignored, so a release build pays nothing.
+//
+// Values accumulate over runs until reset(). Work done on ThreadPool workers
+// (parallel mapping) is timed as a whole but not counted per lookup.
+//
+//   camt::Stats st;
+//   camt::ParseOptions po; po.stats = &st;
+//   camt::ExportOptions eo; eo.stats = &st;
+//   ... parse, export ...
+//   st.write_prometheus(metrics, "file=\"2025-03.xml\"");
+struct Stats {
+    enum Phase {
+        Load,        // pugixml: input -> DOM
+        Map,         // DOM -> Document
+        Normalize,   // canonical row values (export)
+        Gvc,         // GVC lookups (export)
+        CsvWrite,    // escaping and buffering CSV cells (export)
+        Export,      // export_entries_csv() as a whole
+        PhaseCount
+    };
+
+    std::uint64_t bytesRead = 0;      // XML input
+    std::uint64_t xmlNodes = 0;       // element nodes of the loaded DOMs
+    std::uint64_t statements = 0;
+    std::uint64_t entries = 0;
+    std::uint64_t transactions = 0;
+    std::uint64_t descFallbacks = 0;  // desc_any() deep searches
+    std::uint64_t rows = 0;           // exported rows
+    std::uint64_t allocations = 0;    // see stats_record_allocation()
+    std::uint64_t allocatedBytes = 0;
+    std::uint64_t nanos[PhaseCount] = {};
+
+    void reset() { *this = Stats(); }
+
+    double seconds(Phase p) const { return (double)nanos[p] * 1e-9; }
+
+    static const char* phase_name(Phase p)
+    {
+        static const char* names[PhaseCount] = {"load", "map", "normalize", "gvc", "csv_write", "export"};
+        return p < PhaseCount ? names[p] : "";
+    }
+
+    // Prometheus text format; labels without braces, e.g. file="a.xml"
+    void write_prometheus(std::ostream& os, std::string_view labels = {}, std::string_view prefix = "camt_") const
+    {
+        auto line = [&](const char* name, std::string_view extra, auto value) {
+            os << prefix << name;
+            if (!labels.empty() || !extra.empty()) {
+                os << '{' << labels;
+                if (!labels.empty() && !extra.empty()) os << ',';
+                os << extra << '}';
+            }
+            os << ' ' << value << '\n';
+        };
+        line("bytes_read_total", {}, bytesRead);
+        line("xml_nodes_total", {}, xmlNodes);
+        line("statements_total", {}, statements);
+        line("entries_total", {}, entries);
+        line("transactions_total", {}, transactions);
+        line("desc_fallbacks_total", {}, descFallbacks);
+        line("rows_total", {}, rows);
+        line("allocations_total", {}, allocations);
+        line("allocated_bytes_total", {}, allocatedBytes);
+        for (int p = 0; p < PhaseCount; ++p) {
+            const std::string extra = std::string("phase=\"") + phase_name((Phase)p) + "\"";
+            line("phase_seconds_total", extra, seconds((Phase)p));
+        }
+    }
+};
+
+namespace detail {
+// Stats of the parse or export running on this thread (set by StatsScope)
+inline Stats*& current_stats()
+{
+    static thread_local Stats* s = nullptr;
+    return s;
+}
+} // namespace detail
+
+// Allocation hook: call it from your own allocator or a replaced global
+// operator new; it counts into the Stats of the run active on this thread.
+inline void stats_record_allocation(std::size_t bytes)
+{
+    if (Stats* s = detail::current_stats()) {
+        ++s->allocations;
+        s->allocatedBytes += bytes;
+    }
+}
+
+// makes s the current Stats of this thread for the lifetime of the scope
+class StatsScope {
+public:
+    explicit StatsScope(Stats* s) : prev_(detail::current_stats()) { if (s) detail::current_stats() = s; }
+    ~StatsScope() { detail::current_stats() = prev_; }
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+private:
+    Stats* prev_;
+};
+
+// adds the time until destruction (or stop()) to a phase; no-op for nullptr
+class StatsTimer {
+public:
+    StatsTimer(Stats* s, Stats::Phase p) : s_(s), p_(p)
+    {
+        if (s_) t0_ = std::chrono::steady_clock::now();
+    }
+    ~StatsTimer() { stop(); }
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+    void stop()
+    {
+        if (!s_) return;
+        s_->nanos[p_] += (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0_).count();
+        s_ = nullptr;
+    }
+
+private:
+    Stats* s_;
+    Stats::Phase p_;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+} // namespace camt
+
+#ifdef CAMT_STATS
+#define CAMT_STAT_ADD(stats, field, n) do { if (::camt::Stats* s_ = (stats)) s_->field += (n); } while (0)
+#define CAMT_STAT_TIMER(var, stats, phase) ::camt::StatsTimer var((stats), ::camt::Stats::phase)
+#define CAMT_STAT_STOP(var) var.stop()
+#define CAMT_STAT_SCOPE(var, stats) ::camt::StatsScope var((stats))
+#else
+#define CAMT_STAT_ADD(stats, field, n) do { } while (0)
+#define CAMT_STAT_TIMER(var, stats, phase) do { } while (0)
+#define CAMT_STAT_STOP(var) do { } while (0)
+#define CAMT_STAT_SCOPE(var, stats) do { } while (0)
+#endif
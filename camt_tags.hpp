@@ -0,0 +1,187 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <pugixml.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace camt {
+
+// ---------- Tag IDs ----------
+// Local names of the CAMT elements the parser reads, as a compact enum.
+// tag_of() hashes a node name once (namespace prefix skipped) and resolves it
+// through a constexpr open-addressing table, so the parse functions can compare
+// small integers instead of calling strcmp per sibling and field.
+enum class Tag : std::uint8_t {
+    Unknown,
+    Acct, AcctSvcrRef, AddtlRmtInf, AddtlTxInf, Agt, Amt, AmtDtls, Bal,
+    BIC, BICFI, BkToCstmrAcctRpt, BkToCstmrDbtCdtNtfctn, BkToCstmrStmt, BkTxCd, BookgDt, Ccy, CcyXchg,
+    Cd, CdOrPrtry, CdtDbtInd, Cdtr, CdtrAcct, CdtrAgt, CdtrRefInf, ChrgInclInd,
+    Chrgs, CntrValAmt, CreDtTm, Dbtr, DbtrAcct, DbtrAgt, Document, Domn,
+    Dt, DtTm, EndToEndId, FinInstnId, Fmly, GrpHdr, IBAN, Id,
+    InstdAmt, Issr, MndtId, MsgId, MsgRcpt, Nm, Ntfctn, Ntry,
+    NtryDtls, NtryRef, Othr, Prtry, PrtryBkTxCd, Purp, Rcrd, Ref,
+    RefTp, Refs, RltdAgts, RltdPties, RmtInf, Rpt, RvslInd, SrcCcy,
+    Stmt, Strd, Sts, SubFmlyCd, Svcr, Tp, TrgtCcy, TtlChrgsAndTaxAmt,
+    TxAmt, TxDtls, TxId, UltmtCdtr, UltmtDbtr, UnitCcy, Ustrd, ValDt, XchgRate,
+    Count
+};
+
+inline constexpr const char* kTagNames[] = {
+    "",
+    "Acct", "AcctSvcrRef", "AddtlRmtInf", "AddtlTxInf", "Agt", "Amt",
+    "AmtDtls", "Bal", "BIC", "BICFI", "BkToCstmrAcctRpt", "BkToCstmrDbtCdtNtfctn",
+    "BkToCstmrStmt", "BkTxCd", "BookgDt", "Ccy", "CcyXchg", "Cd", "CdOrPrtry",
+    "CdtDbtInd", "Cdtr", "CdtrAcct", "CdtrAgt", "CdtrRefInf", "ChrgInclInd",
+    "Chrgs", "CntrValAmt", "CreDtTm", "Dbtr", "DbtrAcct", "DbtrAgt",
+    "Document", "Domn", "Dt", "DtTm", "EndToEndId", "FinInstnId",
+    "Fmly", "GrpHdr", "IBAN", "Id", "InstdAmt", "Issr",
+    "MndtId", "MsgId", "MsgRcpt", "Nm", "Ntfctn", "Ntry",
+    "NtryDtls", "NtryRef", "Othr", "Prtry", "PrtryBkTxCd", "Purp",
+    "Rcrd", "Ref", "RefTp", "Refs", "RltdAgts", "RltdPties",
+    "RmtInf", "Rpt", "RvslInd", "SrcCcy", "Stmt", "Strd",
+    "Sts", "SubFmlyCd", "Svcr", "Tp", "TrgtCcy", "TtlChrgsAndTaxAmt",
+    "TxAmt", "TxDtls", "TxId", "UltmtCdtr", "UltmtDbtr", "UnitCcy",
+    "Ustrd", "ValDt", "XchgRate",
+};
+static_assert(sizeof(kTagNames) / sizeof(kTagNames[0]) == (std::size_t)Tag::Count, "kTagNames out of sync with Tag");
+
+namespace detail {
+
+constexpr std::uint32_t tag_hash(const char* s, std::size_t n) {
+    std::uint32_t h = 2166136261u; // FNV-1a
+    for (std::size_t i = 0; i < n; ++i) h = (h ^ (unsigned char)s[i]) * 16777619u;
+    return h;
+}
+constexpr std::size_t tag_len(const char* s) {
+    std::size_t n = 0;
+    while (s[n]) ++n;
+    return n;
+}
+
+constexpr std::size_t kTagSlots = 256; // power of two, load < 1/3
+
+struct TagTable {
+    std::array<std::uint8_t, kTagSlots> slot{};  // Tag value, 0 = empty
+};
+
+constexpr TagTable make_tag_table() {
+    TagTable t{};
+    for (std::size_t i = 1; i < (std::size_t)Tag::Count; ++i) {
+        std::size_t h = tag_hash(kTagNames[i], tag_len(kTagNames[i])) & (kTagSlots - 1);
+        while (t.slot[h] != 0) h = (h + 1) & (kTagSlots - 1);
+        t.slot[h] = (std::uint8_t)i;
+    }
+    return t;
+}
+
+inline constexpr TagTable kTagTable = make_tag_table();
+
+} // namespace detail
+
+// tag of a local name (Tag::Unknown for names the parser does not use)
+inline Tag tag_of(std::string_view local) {
+    std::size_t h = detail::tag_hash(local.data(), local.size()) & (detail::kTagSlots - 1);
+    for (;;) {
+        const std::uint8_t t = detail::kTagTable.slot[h];
+        if (t == 0) return Tag::Unknown;
+        const char* name = kTagNames[t];
+        if (std::strncmp(name, local.data(), local.size()) == 0 && name[local.size()] == 0) return (Tag)t;
+        h = (h + 1) & (detail::kTagSlots - 1);
+    }
+}
+
+// tag of an element, namespace prefix ignored
+inline Tag tag_of(const pugi::xml_node& n) {
+    const char* full = n.name();
+    const char* local = full;
+    const char* p = full;
+    for (; *p; ++p)
+        if (*p == ':') local = p + 1;
+    return tag_of(std::string_view(local, (std::size_t)(p - local)));
+}
+
+// First child per tag, built in one pass over the children. Used for the
+// elements whose fields are looked up one by one (TxDtls, Ntry, Refs, ...):
+// one hash per child instead of one strcmp per child and field.
+class ChildIndex {
+public:
+    explicit ChildIndex(const pugi::xml_node& parent) {
+        for (pugi::xml_node c = parent.first_child(); c; c = c.next_sibling()) {
+            if (c.type() != pugi::node_element) continue;
+            const Tag t = tag_of(c);
+            if (t == Tag::Unknown) continue;
+            const unsigned bit = (unsigned)t;
+            std::uint64_t& word = seen_[bit >> 6];
+            const std::uint64_t mask = std::uint64_t(1) << (bit & 63);
+            if (word & mask) continue; // first match wins, like child_any()
+            word |= mask;
+            tags_[n_] = t;
+            nodes_[n_] = c;
+            ++n_;
+        }
+    }
+
+    // first child with that tag, or a null node
+    pugi::xml_node operator[](Tag t) const {
+        for (std::size_t i = 0; i < n_; ++i)
+            if (tags_[i] == t) return nodes_[i];
+        return pugi::xml_node();
+    }
+
+private:
+    static constexpr std::size_t kMax = (std::size_t)Tag::Count;
+    static_assert(kMax <= 128, "seen_ holds 128 bits");
+
+    std::uint64_t seen_[2] = {0, 0};
+    std::size_t n_ = 0;
+    Tag tags_[kMax];
+    pugi::xml_node nodes_[kMax];
+};
+
+// ---------- Descendant search ----------
+// Pre-order walk over the descendants of p (document order, p itself
+// excluded), without recursion. f(node) returns false to stop the walk.
+template <class F>
+inline void walk_desc(const pugi::xml_node& p, F&& f) {
+    pugi::xml_node c = p.first_child();
+    while (c) {
+        if (!f(c)) return;
+        if (pugi::xml_node fc = c.first_child()) { c = fc; continue; }
+        while (!c.next_sibling()) {
+            c = c.parent();
+            if (c == p) return;
+        }
+        c = c.next_sibling();
+    }
+}
+
+// First descendant per wanted tag, collected in one walk that ends as soon as
+// every tag has been found. out[i] is the node desc_any(p, tags[i]) returns:
+//   auto [nm, iban] = collect_desc(party, {Tag::Nm, Tag::IBAN});
+template <std::size_t N>
+inline std::array<pugi::xml_node, N> collect_desc(const pugi::xml_node& p, const Tag (&tags)[N]) {
+    std::array<pugi::xml_node, N> out{};
+    std::size_t missing = N;
+    walk_desc(p, [&](const pugi::xml_node& c) {
+        if (c.type() != pugi::node_element) return true;
+        const Tag t = tag_of(c);
+        if (t == Tag::Unknown) return true;
+        for (std::size_t i = 0; i < N; ++i)
+            if (tags[i] == t && !out[i]) { out[i] = c; --missing; }
+        return missing != 0;
+    });
+    return out;
+}
+
+} // namespace camt
@@ -0,0 +1,235 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace camt {
+
+// ---------- Work-stealing thread pool ----------
+// Every worker owns a deque: it pops its own tasks LIFO (cache-warm) and
+// steals FIFO from the others when it runs dry. Tasks submitted from outside
+// the pool are spread round-robin. parallel_for() lets the calling thread
+// work on the pool's tasks while it waits, so it can be nested inside a task
+// (e.g. a batch worker that parses one large document in parallel).
+//
+// Tasks must not throw, except inside parallel_for(), which forwards the
+// first exception to its caller.
+class ThreadPool {
+public:
+    // threads == 0: std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0)
+    {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; ++i) queues_.emplace_back(new Queue);
+        for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i]{ worker(i); });
+    }
+
+    // runs the queued tasks, then joins the workers
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(sleepM_);
+            stop_ = true;
+        }
+        sleepCv_.notify_all();
+        for (std::thread& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers_.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        const int self = current_index();
+        const std::size_t q = self >= 0 ? (std::size_t)self
+                                        : (next_.fetch_add(1, std::memory_order_relaxed) % queues_.size());
+        {
+            std::lock_guard<std::mutex> lk(queues_[q]->m);
+            queues_[q]->tasks.push_back(std::move(task));
+        }
+        pending_.fetch_add(1, std::memory_order_release);
+        { std::lock_guard<std::mutex> lk(sleepM_); } // no lost wake-up between predicate check and wait
+        sleepCv_.notify_one();
+    }
+
+    // fn(begin, end) over [0, count) in chunks of 'grain' indices; returns when
+    // all chunks are done. The calling thread executes pool tasks meanwhile.
+    template <class F>
+    void parallel_for(std::size_t count, std::size_t grain, F&& fn)
+    {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        const std::size_t chunks = (count + grain - 1) / grain;
+
+        struct Group {
+            std::mutex m;
+            std::condition_variable cv;
+            std::size_t remaining;
+            std::exception_ptr error;
+        } g;
+        g.remaining = chunks;
+
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const std::size_t b = c * grain;
+            const std::size_t e = (b + grain < count) ? b + grain : count;
+            submit([&g, &fn, b, e]{
+                std::exception_ptr ex;
+                try { fn(b, e); } catch (...) { ex = std::current_exception(); }
+                // notify under the lock: g lives on the waiting thread's stack
+                std::lock_guard<std::mutex> lk(g.m);
+                if (ex && !g.error) g.error = ex;
+                if (--g.remaining == 0) g.cv.notify_all();
+            });
+        }
+
+        const int self = current_index();
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lk(g.m);
+                if (g.remaining == 0) break;
+            }
+            if (try_run_one(self)) continue;
+            std::unique_lock<std::mutex> lk(g.m);
+            g.cv.wait_for(lk, std::chrono::milliseconds(1), [&]{ return g.remaining == 0; });
+        }
+        if (g.error) std::rethrow_exception(g.error);
+    }
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // index of the calling worker thread in this pool, -1 for other threads
+    int current_index() const
+    {
+        return tlsPool() == this ? tlsIndex() : -1;
+    }
+    static const ThreadPool*& tlsPool() { static thread_local const ThreadPool* p = nullptr; return p; }
+    static int& tlsIndex() { static thread_local int i = -1; return i; }
+
+    // own queue from the back, then steal from the front of the others
+    bool try_run_one(int self)
+    {
+        std::function<void()> task;
+        const std::size_t n = queues_.size();
+        if (self >= 0) {
+            Queue& q = *queues_[(std::size_t)self];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (!q.tasks.empty()) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+        }
+        for (std::size_t k = 0; !task && k < n; ++k) {
+            const std::size_t v = self >= 0 ? ((std::size_t)self + 1 + k) % n : k;
+            if ((int)v == self) continue;
+            Queue& q = *queues_[v];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (!q.tasks.empty()) {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+        if (!task) return false;
+        pending_.fetch_sub(1, std::memory_order_acq_rel);
+        task();
+        return true;
+    }
+
+    void worker(unsigned index)
+    {
+        tlsPool() = this;
+        tlsIndex() = (int)index;
+        for (;;) {
+            if (try_run_one((int)index)) continue;
+            std::unique_lock<std::mutex> lk(sleepM_);
+            sleepCv_.wait(lk, [&]{ return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+            if (stop_ && pending_.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> pending_{0};   // queued, not yet started
+    std::atomic<std::size_t> next_{0};      // round-robin for external submits
+    std::mutex sleepM_;
+    std::condition_variable sleepCv_;
+    bool stop_ = false;
+};
+
+// std::sort on the pool: the range is split into about 4 chunks per
+// thread, the chunks are sorted in parallel and merged pairwise in rounds
+// (through a buffer of n elements). Sequential without a pool or for small
+// ranges. Not stable; make the comparator total (e.g. with the original index
+// as last key) to get a deterministic order.
+template <class It, class Cmp>
+inline void parallel_sort(ThreadPool* pool, It first, It last, Cmp cmp, std::size_t minParallel = 1u << 15)
+{
+    const std::size_t n = (std::size_t)std::distance(first, last);
+    if (!pool || pool->size() < 2 || n < minParallel) {
+        std::sort(first, last, cmp);
+        return;
+    }
+
+    std::size_t chunks = 1;
+    while (chunks < 4 * (std::size_t)pool->size()) chunks *= 2;
+    const std::size_t grain = (n + chunks - 1) / chunks;
+    pool->parallel_for(n, grain, [&](std::size_t b, std::size_t e) {
+        std::sort(first + (std::ptrdiff_t)b, first + (std::ptrdiff_t)e, cmp);
+    });
+
+    using T = typename std::iterator_traits<It>::value_type;
+    std::vector<T> buf(n);
+    bool inBuf = false; // current runs are in buf (else in [first, last))
+    for (std::size_t run = grain; run < n; run *= 2) {
+        const std::size_t pairs = (n + 2 * run - 1) / (2 * run);
+        pool->parallel_for(pairs, 1, [&](std::size_t pb, std::size_t pe) {
+            for (std::size_t p = pb; p < pe; ++p) {
+                const std::size_t lo = p * 2 * run;
+                const std::size_t mid = std::min(lo + run, n);
+                const std::size_t hi = std::min(lo + 2 * run, n);
+                if (inBuf) {
+                    std::merge(std::make_move_iterator(buf.begin() + (std::ptrdiff_t)lo),
+                               std::make_move_iterator(buf.begin() + (std::ptrdiff_t)mid),
+                               std::make_move_iterator(buf.begin() + (std::ptrdiff_t)mid),
+                               std::make_move_iterator(buf.begin() + (std::ptrdiff_t)hi),
+                               first + (std::ptrdiff_t)lo, cmp);
+                } else {
+                    std::merge(std::make_move_iterator(first + (std::ptrdiff_t)lo),
+                               std::make_move_iterator(first + (std::ptrdiff_t)mid),
+                               std::make_move_iterator(first + (std::ptrdiff_t)mid),
+                               std::make_move_iterator(first + (std::ptrdiff_t)hi),
+                               buf.begin() + (std::ptrdiff_t)lo, cmp);
+                }
+            }
+        });
+        inBuf = !inBuf;
+    }
+    if (inBuf) std::move(buf.begin(), buf.end(), first);
+}
+
+} // namespace camt
@@ -0,0 +1,508 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include "camt_model.hpp"
+#include "camt_parser_pugi.hpp"
+#include "mapped_file.hpp"
+#include <memory_resource>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+namespace camt {
+
+// ---------- Read-only view model ----------
+// Same layout as camt_model.hpp, but every string is a std::string_view into
+// the parsed XML (owned by the DocumentView) and every array lives in the
+// document's monotonic arena. Nothing is copied or freed per field; the whole
+// document is released at once. Use to_owned() to get a regular Document.
+
+// called for every element an ArenaVector default-constructs, so that nested
+// arrays allocate from the same arena (overloaded below for the view structs)
+template <class T>
+inline void bind_arena(T&, std::pmr::memory_resource*) {}
+
+// Growable array with storage from a memory_resource. Elements are trivially
+// copyable and never destroyed (the arena releases them); copies of an
+// ArenaVector share the storage.
+template <class T>
+class ArenaVector {
+public:
+    using value_type = T;
+
+    ArenaVector() = default;
+    explicit ArenaVector(std::pmr::memory_resource* r) : res_(r) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T* data() const { return data_; }
+    T* data() { return data_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& front() const { return data_[0]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    // new elements are value-initialized and bound to this vector's arena
+    void resize(std::size_t n) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "ArenaVector elements are moved with memcpy and never destroyed");
+        if (n > cap_) grow(n);
+        for (std::size_t i = size_; i < n; ++i) {
+            ::new ((void*)(data_ + i)) T();
+            bind_arena(data_[i], res_);
+        }
+        size_ = n;
+    }
+
+private:
+    void grow(std::size_t n) {
+        std::size_t c = cap_ ? cap_ * 2 : 4;
+        if (c < n) c = n;
+        T* p = static_cast<T*>(res_->allocate(c * sizeof(T), alignof(T)));
+        if (size_) std::memcpy((void*)p, (const void*)data_, size_ * sizeof(T));
+        data_ = p;
+        cap_ = c;
+    }
+
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t cap_ = 0;
+    std::pmr::memory_resource* res_ = nullptr;
+};
+
+struct CurrencyAmountView {
+    std::string_view currency;
+    std::int64_t minor{0};
+};
+
+struct AccountIdView {
+    std::string_view iban;
+    std::string_view other;
+};
+
+struct AgentView {
+    std::string_view bic;
+    std::string_view name;
+};
+
+struct AccountView {
+    AccountIdView id;
+    std::string_view name;
+    std::string_view currency;
+    AgentView servicer;
+};
+
+struct PartyView {
+    std::string_view name;
+    std::string_view iban;
+    std::string_view bic;
+};
+
+struct PurposeView {
+    std::string_view code;
+    std::string_view proprietary;
+};
+
+struct ReferencesView {
+    std::string_view endToEndId;
+    std::string_view txId;
+    std::string_view acctSvcrRef;
+    std::string_view mandateId;
+    std::string_view msgId;
+};
+
+struct BankTransactionCodeView {
+    std::string_view domain;
+    std::string_view family;
+    std::string_view subFamily;
+    std::string_view proprietary;
+};
+
+struct ProprietaryBankTransactionCodeView {
+    std::string_view code;
+    std::string_view issuer;
+};
+
+struct StructuredRemittanceView {
+    std::string_view creditorRefType;
+    std::string_view creditorRef;
+    std::string_view additionalInfo;
+};
+struct RemittanceInformationView {
+    ArenaVector<std::string_view> unstructured;
+    ArenaVector<StructuredRemittanceView> structured;
+};
+
+struct RelatedPartiesView {
+    PartyView debtor;
+    AccountIdView debtorAccount;
+    PartyView ultimateDebtor;
+    PartyView creditor;
+    AccountIdView creditorAccount;
+    PartyView ultimateCreditor;
+};
+
+struct RelatedAgentsView {
+    AgentView debtorAgent;
+    AgentView creditorAgent;
+};
+
+struct ChargesRecordView {
+    CurrencyAmountView amount;
+    AgentView agent;
+    bool hasCdtDbtInd = false;
+    bool isCredit     = false;
+    bool included     = false;
+};
+
+struct ChargesView {
+    CurrencyAmountView total;
+    ArenaVector<ChargesRecordView> records;
+};
+
+struct FxRateInfoView {
+    std::string_view srcCcy, trgtCcy, unitCcy;
+    double rate = 0.0;
+    bool   has  = false;
+};
+
+struct EntryTransactionView {
+    ReferencesView refs;
+    RelatedPartiesView parties;
+    RelatedAgentsView agents;
+    RemittanceInformationView remittance;
+    PurposeView purpose;
+    BankTransactionCodeView bankTxCode;
+    ProprietaryBankTransactionCodeView proprietaryBankTxCode;
+    ChargesView charges;
+    std::string_view additionalInfo;
+    std::optional<CurrencyAmountView> txAmount;
+    std::string_view dtaCode;
+    std::string_view gvc;
+    bool hasCdtDbtInd = false;
+    bool isCredit     = false;
+    std::string_view codeSwift;
+    FxRateInfoView     fx;
+    CurrencyAmountView fxInstdAmt;
+    CurrencyAmountView fxTxAmt;
+    CurrencyAmountView fxCounterValAmt;
+    bool               hasFxInstdAmt = false;
+    bool               hasFxTxAmt    = false;
+    bool               hasFxCntrVal  = false;
+    int                importOrdinal{-1};
+};
+
+struct EntryView {
+    CurrencyAmountView amount;
+    bool isCredit{false};
+    std::string_view bookingDate;
+    std::string_view valueDate;
+    int bookingDateInt{0};
+    int valueDateInt{0};
+    std::string_view entryRef;
+    ArenaVector<EntryTransactionView> transactions;
+    bool reversal{false};
+    std::string_view status;
+    std::string_view acctSvcrRef;
+    int importOrdinal{-1};
+};
+
+struct BalanceView {
+    std::string_view type;
+    CurrencyAmountView amount;
+    std::string_view date;
+    bool hasCdtDbtInd = false;
+    bool isCredit     = true;
+};
+
+struct GroupHeaderView {
+    std::string_view msgId;
+    std::string_view creationDateTime;
+    std::string_view messageRecipient;
+};
+
+struct StatementView {
+    std::string_view id;
+    std::string_view creationDateTime;
+    AccountView account;
+    GroupHeaderView groupHeader;
+    ArenaVector<BalanceView> balances;
+    ArenaVector<EntryView> entries;
+};
+
+inline void bind_arena(RemittanceInformationView& r, std::pmr::memory_resource* a) {
+    r.unstructured = ArenaVector<std::string_view>(a);
+    r.structured = ArenaVector<StructuredRemittanceView>(a);
+}
+inline void bind_arena(ChargesView& c, std::pmr::memory_resource* a) {
+    c.records = ArenaVector<ChargesRecordView>(a);
+}
+inline void bind_arena(EntryTransactionView& t, std::pmr::memory_resource* a) {
+    bind_arena(t.remittance, a);
+    bind_arena(t.charges, a);
+}
+inline void bind_arena(EntryView& e, std::pmr::memory_resource* a) {
+    e.transactions = ArenaVector<EntryTransactionView>(a);
+}
+inline void bind_arena(StatementView& s, std::pmr::memory_resource* a) {
+    s.balances = ArenaVector<BalanceView>(a);
+    s.entries = ArenaVector<EntryView>(a);
+}
+
+// ---------- View -> owned model ----------
+inline CurrencyAmount to_owned(const CurrencyAmountView& v) {
+    return CurrencyAmount{ std::string(v.currency), v.minor };
+}
+inline AccountId to_owned(const AccountIdView& v) {
+    return AccountId{ std::string(v.iban), std::string(v.other) };
+}
+inline Agent to_owned(const AgentView& v) {
+    return Agent{ std::string(v.bic), std::string(v.name) };
+}
+inline Account to_owned(const AccountView& v) {
+    return Account{ to_owned(v.id), std::string(v.name), std::string(v.currency), to_owned(v.servicer) };
+}
+inline Party to_owned(const PartyView& v) {
+    return Party{ std::string(v.name), std::string(v.iban), std::string(v.bic) };
+}
+inline Purpose to_owned(const PurposeView& v) {
+    return Purpose{ std::string(v.code), std::string(v.proprietary) };
+}
+inline References to_owned(const ReferencesView& v) {
+    return References{ std::string(v.endToEndId), std::string(v.txId), std::string(v.acctSvcrRef),
+                       std::string(v.mandateId), std::string(v.msgId) };
+}
+inline BankTransactionCode to_owned(const BankTransactionCodeView& v) {
+    return BankTransactionCode{ std::string(v.domain), std::string(v.family),
+                                std::string(v.subFamily), std::string(v.proprietary) };
+}
+inline ProprietaryBankTransactionCode to_owned(const ProprietaryBankTransactionCodeView& v) {
+    return ProprietaryBankTransactionCode{ std::string(v.code), std::string(v.issuer) };
+}
+inline StructuredRemittance to_owned(const StructuredRemittanceView& v) {
+    return StructuredRemittance{ std::string(v.creditorRefType), std::string(v.creditorRef),
+                                 std::string(v.additionalInfo) };
+}
+inline RemittanceInformation to_owned(const RemittanceInformationView& v) {
+    RemittanceInformation r;
+    r.unstructured.reserve(v.unstructured.size());
+    for (std::string_view s : v.unstructured) r.unstructured.emplace_back(s);
+    r.structured.reserve(v.structured.size());
+    for (const StructuredRemittanceView& s : v.structured) r.structured.push_back(to_owned(s));
+    return r;
+}
+inline RelatedParties to_owned(const RelatedPartiesView& v) {
+    return RelatedParties{ to_owned(v.debtor), to_owned(v.debtorAccount), to_owned(v.ultimateDebtor),
+                           to_owned(v.creditor), to_owned(v.creditorAccount), to_owned(v.ultimateCreditor) };
+}
+inline RelatedAgents to_owned(const RelatedAgentsView& v) {
+    return RelatedAgents{ to_owned(v.debtorAgent), to_owned(v.creditorAgent) };
+}
+inline ChargesRecord to_owned(const ChargesRecordView& v) {
+    return ChargesRecord{ to_owned(v.amount), to_owned(v.agent), v.hasCdtDbtInd, v.isCredit, v.included };
+}
+inline Charges to_owned(const ChargesView& v) {
+    Charges c;
+    c.total = to_owned(v.total);
+    c.records.reserve(v.records.size());
+    for (const ChargesRecordView& r : v.records) c.records.push_back(to_owned(r));
+    return c;
+}
+inline FxRateInfo to_owned(const FxRateInfoView& v) {
+    return FxRateInfo{ std::string(v.srcCcy), std::string(v.trgtCcy), std::string(v.unitCcy), v.rate, v.has };
+}
+inline EntryTransaction to_owned(const EntryTransactionView& v) {
+    EntryTransaction t;
+    t.refs = to_owned(v.refs);
+    t.parties = to_owned(v.parties);
+    t.agents = to_owned(v.agents);
+    t.remittance = to_owned(v.remittance);
+    t.purpose = to_owned(v.purpose);
+    t.bankTxCode = to_owned(v.bankTxCode);
+    t.proprietaryBankTxCode = to_owned(v.proprietaryBankTxCode);
+    t.charges = to_owned(v.charges);
+    t.additionalInfo = std::string(v.additionalInfo);
+    if (v.txAmount) t.txAmount = to_owned(*v.txAmount);
+    t.dtaCode = std::string(v.dtaCode);
+    t.gvc = std::string(v.gvc);
+    t.hasCdtDbtInd = v.hasCdtDbtInd;
+    t.isCredit = v.isCredit;
+    t.codeSwift = std::string(v.codeSwift);
+    t.fx = to_owned(v.fx);
+    t.fxInstdAmt = to_owned(v.fxInstdAmt);
+    t.fxTxAmt = to_owned(v.fxTxAmt);
+    t.fxCounterValAmt = to_owned(v.fxCounterValAmt);
+    t.hasFxInstdAmt = v.hasFxInstdAmt;
+    t.hasFxTxAmt = v.hasFxTxAmt;
+    t.hasFxCntrVal = v.hasFxCntrVal;
+    t.importOrdinal = v.importOrdinal;
+    return t;
+}
+inline Entry to_owned(const EntryView& v) {
+    Entry e;
+    e.amount = to_owned(v.amount);
+    e.isCredit = v.isCredit;
+    e.bookingDate = std::string(v.bookingDate);
+    e.valueDate = std::string(v.valueDate);
+    e.bookingDateInt = v.bookingDateInt;
+    e.valueDateInt = v.valueDateInt;
+    e.entryRef = std::string(v.entryRef);
+    e.transactions.reserve(v.transactions.size());
+    for (const EntryTransactionView& t : v.transactions) e.transactions.push_back(to_owned(t));
+    e.reversal = v.reversal;
+    e.status = std::string(v.status);
+    e.acctSvcrRef = std::string(v.acctSvcrRef);
+    e.importOrdinal = v.importOrdinal;
+    return e;
+}
+inline Balance to_owned(const BalanceView& v) {
+    return Balance{ std::string(v.type), to_owned(v.amount), std::string(v.date), v.hasCdtDbtInd, v.isCredit };
+}
+inline GroupHeader to_owned(const GroupHeaderView& v) {
+    return GroupHeader{ std::string(v.msgId), std::string(v.creationDateTime), std::string(v.messageRecipient) };
+}
+inline Statement to_owned(const StatementView& v) {
+    Statement s;
+    s.id = std::string(v.id);
+    s.creationDateTime = std::string(v.creationDateTime);
+    s.account = to_owned(v.account);
+    s.groupHeader = to_owned(v.groupHeader);
+    s.balances.reserve(v.balances.size());
+    for (const BalanceView& b : v.balances) s.balances.push_back(to_owned(b));
+    s.entries.reserve(v.entries.size());
+    for (const EntryView& e : v.entries) s.entries.push_back(to_owned(e));
+    return s;
+}
+
+namespace detail { struct SnapshotAccess; } // camt_snapshot.hpp
+
+// ---------- DocumentView ----------
+// Owns the XML text (memory-mapped file or string), the DOM parsed in place
+// over it and the arena; the views stay valid until the next parse or until
+// the DocumentView is destroyed. Movable, not copyable. gzip input is
+// inflated in memory and the views point into the inflated text; a ZIP
+// archive is rejected (extract its members with ZipArchive::extract()).
+// load_snapshot() (camt_snapshot.hpp) fills it from a mapped snapshot file
+// instead.
+class DocumentView {
+public:
+    DocKind kind{DocKind::Unknown};
+    ArenaVector<StatementView> statements;
+
+    DocumentView() = default;
+
+    // memory-maps the file (copy-on-write) and parses it in place
+    bool parse_file(const std::string& utf8Path, std::string* error = nullptr)
+    {
+        reset();
+        const std::filesystem::path p = std::filesystem::u8path(utf8Path);
+        if (!check_input_file(p, utf8Path, error)) {
+            return false;
+        }
+        std::string sysMsg;
+        if (!map_.open(p, &sysMsg)) {
+            if (error) {
+                *error = std::string("Open failed for '") + utf8Path + "': " + sysMsg;
+            }
+            return false;
+        }
+        return load(map_.data(), map_.size(), error);
+    }
+
+    bool parse_string(const std::string& xml_utf8, std::string* error = nullptr)
+    {
+        return parse_buffer(xml_utf8.data(), xml_utf8.size(), error);
+    }
+
+    // the data is copied into the DocumentView and parsed in place
+    bool parse_buffer(const char* data, std::size_t size, std::string* error = nullptr)
+    {
+        reset();
+        text_.assign(data, data + size);
+        return load(text_.data(), text_.size(), error);
+    }
+
+    Document to_owned() const
+    {
+        Document d;
+        d.kind = kind;
+        d.statements.reserve(statements.size());
+        for (const StatementView& s : statements) d.statements.push_back(camt::to_owned(s));
+        return d;
+    }
+
+private:
+    friend struct detail::SnapshotAccess;
+
+    void reset()
+    {
+        kind = DocKind::Unknown;
+        statements = ArenaVector<StatementView>();
+        arena_.reset();
+        if (dom_) dom_->reset();
+        map_.close();
+        std::vector<char>().swap(text_);
+    }
+
+    bool load(char* data, std::size_t size, std::string* error)
+    {
+        switch (detect_compression(data, size)) {
+        case Compression::Gzip: {
+            std::string xml;
+            if (!gunzip(data, size, xml, error)) return false;
+            text_.assign(xml.begin(), xml.end());
+            map_.close();
+            data = text_.data();
+            size = text_.size();
+            break;
+        }
+        case Compression::Zip:
+            if (error) *error = detail::zip_unsupported_message();
+            return false;
+        case Compression::None:
+            break;
+        }
+
+        // the views take roughly half the size of the XML
+        arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(std::max<std::size_t>(4096, size / 2));
+        statements = ArenaVector<StatementView>(arena_.get());
+
+        if (!dom_) dom_ = std::make_unique<pugi::xml_document>(); // none yet, or moved from
+        pugi::xml_parse_result res = dom_->load_buffer_inplace(data, size, pugi::parse_default | pugi::parse_declaration);
+        if (!res)
+        {
+            if(error)
+            {
+                *error=xmlErr;
+                (*error) += res.description();
+            }
+            return false;
+        }
+        return parse_document(*dom_, *this, 0, error);
+    }
+
+    MappedFile map_;
+    std::vector<char> text_;       // parse_buffer() input or inflated gzip (a vector keeps its address on move)
+    std::unique_ptr<pugi::xml_document> dom_;  // allocated by load(), null after a move
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+
+    const char* xmlErr="XML file parse error: ";
+};
+
+} // namespace camt
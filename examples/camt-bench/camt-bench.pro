@@ -0,0 +1,9 @@
+CONFIG += c++17 console release
+CONFIG -= qt app_bundle
+TEMPLATE = app
+TARGET = camt-bench
+
+include(../../camt-parser.pri)
+
+HEADERS += camt_generator.hpp
+SOURCES += main.cpp
@@ -0,0 +1,212 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+#include <camt_model.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace camt_bench {
+
+// ---------- Synthetic CAMT documents ----------
+// Deterministic generator for camt.052/053/054 documents: the same options
+// (and seed) give the same bytes on every platform, so benchmark numbers of
+// different builds can be compared. The content uses every part the parser
+// maps (parties, agents, remittance, codes, FX, charges, balances).
+struct GeneratorOptions {
+    camt::DocKind kind = camt::DocKind::Camt053;
+    int statements = 1;
+    int entriesPerStatement = 1000;
+    int txPerEntry = 1;            // TxDtls per entry (0..16), 0 = entries without details
+    double fxDensity = 0.1;        // share of transactions with AmtDtls/CcyXchg
+    double chargesDensity = 0.1;   // share of transactions with Chrgs
+    int remittanceLines = 1;       // Ustrd lines per transaction
+    int remittanceLength = 70;     // characters per line
+    std::uint64_t seed = 1;
+};
+
+namespace detail {
+// splitmix64: tiny, and unlike <random> distributions identical everywhere
+class Rng {
+public:
+    explicit Rng(std::uint64_t seed) : s_(seed) {}
+    std::uint64_t next()
+    {
+        std::uint64_t z = (s_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    std::uint64_t below(std::uint64_t n) { return next() % n; }
+    bool chance(double p) { return (double)(next() >> 11) * (1.0 / 9007199254740992.0) < p; }
+
+private:
+    std::uint64_t s_;
+};
+
+inline void tag(std::string& out, const char* name, const std::string& value)
+{
+    out += '<'; out += name; out += '>';
+    out += value;
+    out += "</"; out += name; out += '>';
+}
+
+inline std::string amount(std::uint64_t minor)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%02llu", (unsigned long long)(minor / 100), (unsigned long long)(minor % 100));
+    return buf;
+}
+
+inline void amt(std::string& out, const char* name, std::uint64_t minor, const char* ccy)
+{
+    out += '<'; out += name; out += " Ccy=\""; out += ccy; out += "\">";
+    out += amount(minor);
+    out += "</"; out += name; out += '>';
+}
+
+inline std::string iban(Rng& r)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "DE%02u%08u%010llu", (unsigned)(10 + r.below(90)), (unsigned)(10000000 + r.below(90000000)),
+                  (unsigned long long)r.below(10000000000ull));
+    return buf;
+}
+
+inline std::string text(Rng& r, int length)
+{
+    static const char* words[] = {"Rechnung", "invoice", "Miete", "Gehalt", "Strom", "order", "Kunden-Nr.",
+                                  "Beitrag", "payment", "Lastschrift", "SEPA", "Abschlag", "Vertrag"};
+    std::string s;
+    while ((int)s.size() < length) {
+        if (!s.empty()) s += ' ';
+        if (r.chance(0.3)) s += std::to_string(r.below(1000000));
+        else s += words[r.below(sizeof(words) / sizeof(words[0]))];
+    }
+    s.resize((std::size_t)length);
+    return s;
+}
+} // namespace detail
+
+inline std::string generate_camt(const GeneratorOptions& opt)
+{
+    using namespace detail;
+    Rng r(opt.seed);
+    const char* ns = opt.kind == camt::DocKind::Camt052 ? "052.001.08"
+                   : opt.kind == camt::DocKind::Camt054 ? "054.001.08" : "053.001.08";
+    const char* root = opt.kind == camt::DocKind::Camt052 ? "BkToCstmrAcctRpt"
+                     : opt.kind == camt::DocKind::Camt054 ? "BkToCstmrDbtCdtNtfctn" : "BkToCstmrStmt";
+    const char* stmt = opt.kind == camt::DocKind::Camt052 ? "Rpt"
+                     : opt.kind == camt::DocKind::Camt054 ? "Ntfctn" : "Stmt";
+    static const char* names[] = {"Stadtwerke Musterstadt GmbH", "Max Mustermann", "ACME Corp.", "Erika Musterfrau",
+                                  "Müller &amp; Söhne KG", "Versicherung AG", "Finanzamt", "Online Shop Ltd"};
+    static const char* families[][3] = {{"PMNT", "RCDT", "ESCT"}, {"PMNT", "ICDT", "ESCT"}, {"PMNT", "RDDT", "ESDD"},
+                                        {"PMNT", "IDDT", "ESDD"}, {"ACMT", "MDOP", "CHRG"}, {"PMNT", "RCDT", "SALA"}};
+    static const char* dta[] = {"NTRF+166+9310", "NMSC+201", "NDDT+105+9302", "NTRF+153"};
+
+    std::string x;
+    x.reserve((std::size_t)opt.statements * (std::size_t)opt.entriesPerStatement * (900 + (std::size_t)opt.remittanceLength));
+    x += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    x += "<Document xmlns=\"urn:iso:std:iso:20022:tech:xsd:camt."; x += ns; x += "\">\n<"; x += root; x += ">\n";
+    x += "<GrpHdr><MsgId>BENCH-"; x += std::to_string(opt.seed); x += "</MsgId><CreDtTm>2025-03-31T18:00:00</CreDtTm></GrpHdr>\n";
+
+    for (int s = 0; s < opt.statements; ++s) {
+        x += '<'; x += stmt; x += '>';
+        tag(x, "Id", "STMT-" + std::to_string(s));
+        tag(x, "CreDtTm", "2025-03-31T18:00:00+01:00");
+        x += "<Acct><Id><IBAN>"; x += iban(r); x += "</IBAN></Id><Ccy>EUR</Ccy><Nm>Account ";
+        x += std::to_string(s); x += "</Nm><Svcr><FinInstnId><BICFI>BANKDEFFXXX</BICFI><Nm>Bank AG</Nm></FinInstnId></Svcr></Acct>\n";
+
+        std::int64_t balance = 100000 + (std::int64_t)r.below(10000000);
+        auto bal = [&](const char* code, const char* date) {
+            x += "<Bal><Tp><CdOrPrtry><Cd>"; x += code; x += "</Cd></CdOrPrtry></Tp>";
+            amt(x, "Amt", (std::uint64_t)(balance < 0 ? -balance : balance), "EUR");
+            x += balance < 0 ? "<CdtDbtInd>DBIT</CdtDbtInd>" : "<CdtDbtInd>CRDT</CdtDbtInd>";
+            x += "<Dt><Dt>"; x += date; x += "</Dt></Dt></Bal>\n";
+        };
+        bal(opt.kind == camt::DocKind::Camt052 ? "OPAV" : "OPBD", "2025-03-01");
+
+        for (int e = 0; e < opt.entriesPerStatement; ++e) {
+            const bool credit = r.chance(0.5);
+            const int ntx = opt.txPerEntry < 0 ? 0 : (opt.txPerEntry > 16 ? 16 : opt.txPerEntry);
+            std::uint64_t txAmt[16];
+            std::uint64_t total = 0;
+            for (int t = 0; t < ntx; ++t) total += (txAmt[t] = 100 + r.below(500000));
+            if (ntx == 0) total = 100 + r.below(500000);
+            balance += credit ? (std::int64_t)total : -(std::int64_t)total;
+
+            char date[24];
+            std::snprintf(date, sizeof(date), "2025-03-%02d", 1 + (int)((std::int64_t)e * 28 / opt.entriesPerStatement));
+            const auto& fam = families[r.below(sizeof(families) / sizeof(families[0]))];
+
+            x += "<Ntry>";
+            tag(x, "NtryRef", std::to_string(e + 1));
+            amt(x, "Amt", total, "EUR");
+            x += credit ? "<CdtDbtInd>CRDT</CdtDbtInd>" : "<CdtDbtInd>DBIT</CdtDbtInd>";
+            if (r.chance(0.01)) x += "<RvslInd>true</RvslInd>";
+            x += "<Sts><Cd>BOOK</Cd></Sts><BookgDt><Dt>"; x += date; x += "</Dt></BookgDt><ValDt><Dt>"; x += date; x += "</Dt></ValDt>";
+            tag(x, "AcctSvcrRef", "ASR" + std::to_string(s) + "-" + std::to_string(e));
+            std::string btc = "<BkTxCd><Domn><Cd>";
+            btc += fam[0]; btc += "</Cd><Fmly><Cd>"; btc += fam[1]; btc += "</Cd><SubFmlyCd>"; btc += fam[2];
+            btc += "</SubFmlyCd></Fmly></Domn><Prtry><Cd>"; btc += dta[r.below(4)]; btc += "</Cd><Issr>DK</Issr></Prtry></BkTxCd>";
+            x += btc;
+
+            if (ntx) x += "<NtryDtls>";
+            for (int t = 0; t < ntx; ++t) {
+                const std::uint64_t a = txAmt[t];
+                x += "<TxDtls><Refs>";
+                tag(x, "EndToEndId", r.chance(0.3) ? std::string("NOTPROVIDED") : "E2E-" + std::to_string(r.next() % 100000000));
+                tag(x, "TxId", "TX" + std::to_string(s) + "-" + std::to_string(e) + "-" + std::to_string(t));
+                if (fam[1][1] == 'D') tag(x, "MndtId", "MANDATE-" + std::to_string(r.below(1000)));
+                x += "</Refs>";
+                x += "<AmtDtls>";
+                if (r.chance(opt.fxDensity)) {
+                    const std::uint64_t foreign = a * (80 + r.below(40)) / 100;
+                    x += "<InstdAmt>"; amt(x, "Amt", foreign, "USD");
+                    x += "<CcyXchg><SrcCcy>USD</SrcCcy><TrgtCcy>EUR</TrgtCcy><UnitCcy>USD</UnitCcy><XchgRate>";
+                    x += std::to_string(0.8 + (double)r.below(4000) / 10000.0); x += "</XchgRate></CcyXchg></InstdAmt>";
+                    x += "<TxAmt>"; amt(x, "Amt", a, "EUR"); x += "</TxAmt>";
+                    x += "<CntrValAmt>"; amt(x, "Amt", a, "EUR"); x += "</CntrValAmt>";
+                } else {
+                    x += "<TxAmt>"; amt(x, "Amt", a, "EUR"); x += "</TxAmt>";
+                }
+                x += "</AmtDtls>";
+                x += btc;
+                if (r.chance(opt.chargesDensity)) {
+                    const std::uint64_t fee = 50 + r.below(2000);
+                    x += "<Chrgs>"; amt(x, "TtlChrgsAndTaxAmt", fee, "EUR");
+                    x += "<Rcrd>"; amt(x, "Amt", fee, "EUR");
+                    x += "<CdtDbtInd>DBIT</CdtDbtInd><ChrgInclInd>false</ChrgInclInd><Agt><FinInstnId><BICFI>BANKDEFFXXX</BICFI></FinInstnId></Agt></Rcrd></Chrgs>";
+                }
+                x += "<RltdPties><Dbtr><Nm>"; x += credit ? names[r.below(8)] : "Account Holder"; x += "</Nm></Dbtr>";
+                x += "<DbtrAcct><Id><IBAN>"; x += iban(r); x += "</IBAN></Id></DbtrAcct>";
+                x += "<Cdtr><Nm>"; x += credit ? "Account Holder" : names[r.below(8)]; x += "</Nm></Cdtr>";
+                x += "<CdtrAcct><Id><IBAN>"; x += iban(r); x += "</IBAN></Id></CdtrAcct></RltdPties>";
+                x += "<RltdAgts><DbtrAgt><FinInstnId><BICFI>DBTRDEFFXXX</BICFI></FinInstnId></DbtrAgt>";
+                x += "<CdtrAgt><FinInstnId><BICFI>CDTRDEFFXXX</BICFI></FinInstnId></CdtrAgt></RltdAgts>";
+                x += "<RmtInf>";
+                for (int l = 0; l < opt.remittanceLines; ++l) tag(x, "Ustrd", text(r, opt.remittanceLength));
+                if (r.chance(0.2)) x += "<Strd><CdtrRefInf><Tp><CdOrPrtry><Cd>SCOR</Cd></CdOrPrtry></Tp><Ref>RF18539007547034</Ref></CdtrRefInf></Strd>";
+                x += "</RmtInf>";
+                if (r.chance(0.3)) tag(x, "AddtlTxInf", text(r, 30));
+                x += "</TxDtls>";
+            }
+            if (ntx) x += "</NtryDtls>";
+            x += "</Ntry>\n";
+        }
+        bal(opt.kind == camt::DocKind::Camt052 ? "CLAV" : "CLBD", "2025-03-31");
+        x += "</"; x += stmt; x += ">\n";
+    }
+    x += "</"; x += root; x += ">\n</Document>\n";
+    return x;
+}
+
+} // namespace camt_bench
@@ -0,0 +1,227 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Throughput benchmarks for parser and exporter on generated documents.
+//
+//   camt-bench [--kind 052|053|054] [--statements N] [--entries N] [--tx N]
+//              [--fx P] [--charges P] [--rmt-lines N] [--rmt-len N] [--seed N]
+//              [--min-time SECONDS] [--filter SUBSTRING] [--write FILE]
+//
+// Every benchmark is repeated until min-time has passed (at least 3 runs)
+// and reports the median run with MB/s (of the XML) and entries/s.
+
+#include "camt_generator.hpp"
+#include <camt_parser_pugi.hpp>
+#include <camt_csv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::size_t g_sink = 0; // keeps results alive
+
+// dec_to_minor() on edge inputs, checked at compile time
+struct DecToMinorCase { std::string_view in; int exp; std::int64_t minor; };
+constexpr DecToMinorCase kDecToMinorCases[] = {
+    {"", 2, 0}, {".5", 2, 50}, {"-.5", 2, -50}, {"12.345", 2, 1234}, {"1.", 2, 100},
+    {"1.234,56", 2, 123456}, {"1,234.56", 2, 123456}, {"1.000.000,5", 2, 100000050}, {"1.2.3", 2, 0},
+    {"1'234.56", 2, 123456}, {"1_234.56", 2, 123456}, {"1 2 . 3 4", 2, 1234}, {"\t12\n", 0, 12}, {"\xA0" "5\xA0", 0, 5},
+    {"(12.34)", 2, -1234}, {"(-12.34)", 2, 1234}, {"( 12.34 )", 2, -1234}, {"-(12.34)", 2, 0}, {"()", 2, 0},
+    {"- 12.34", 2, -1234}, {"--1", 2, 0}, {"1e5", 2, 0}, {"1", 19, 0},
+    {"9223372036854775807", 0, 9223372036854775807}, {"9223372036854775808", 0, 0},
+    {"-9223372036854775807", 0, -9223372036854775807}, {"-9223372036854775808", 0, 0},
+    {"18446744073709551616", 0, 0}, {"92233720368547758.07", 2, 9223372036854775807},
+    {"92233720368547758.08", 2, 0}, {"-92233720368547758.08", 2, INT64_MIN},
+    {"-92233720368547758.99", 2, -9223372036854775717},
+};
+constexpr bool dec_to_minor_matches()
+{
+    for (const DecToMinorCase& c : kDecToMinorCases)
+        if (camt::dec_to_minor(c.in, c.exp) != c.minor) return false;
+    return true;
+}
+static_assert(dec_to_minor_matches(), "dec_to_minor edge cases");
+
+double seconds_since(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// discards everything, so that exports measure formatting and not the sink
+class NullBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    int overflow(int c) override { return traits_type::not_eof(c); }
+};
+
+struct Bench {
+    double minTime = 1.0;
+    std::string filter;
+    std::size_t bytes = 0;     // XML size
+    std::size_t entries = 0;   // Ntry count
+
+    // run() returns the measured seconds of one iteration (setup excluded)
+    void operator()(const char* name, const std::function<double()>& run) const
+    {
+        if (!filter.empty() && std::strstr(name, filter.c_str()) == nullptr) return;
+        run(); // warm-up
+        std::vector<double> times;
+        double total = 0.0;
+        while (times.size() < 3 || total < minTime) {
+            times.push_back(run());
+            total += times.back();
+        }
+        std::sort(times.begin(), times.end());
+        const double t = times[times.size() / 2];
+        std::printf("%-22s %6zu runs %10.3f ms %10.1f MB/s %12.0f entries/s\n", name, times.size(), t * 1e3,
+                    (double)bytes / t / 1e6, (double)entries / t);
+    }
+};
+
+bool arg(int argc, char** argv, int& i, const char* name, std::string& value)
+{
+    if (std::strcmp(argv[i], name) != 0 || i + 1 >= argc) return false;
+    value = argv[++i];
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    camt_bench::GeneratorOptions gen;
+    Bench bench;
+    std::string writePath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string v;
+        if (arg(argc, argv, i, "--kind", v)) {
+            gen.kind = v == "052" ? camt::DocKind::Camt052 : v == "054" ? camt::DocKind::Camt054 : camt::DocKind::Camt053;
+        } else if (arg(argc, argv, i, "--statements", v)) gen.statements = std::atoi(v.c_str());
+        else if (arg(argc, argv, i, "--entries", v)) gen.entriesPerStatement = std::atoi(v.c_str());
+        else if (arg(argc, argv, i, "--tx", v)) gen.txPerEntry = std::atoi(v.c_str());
+        else if (arg(argc, argv, i, "--fx", v)) gen.fxDensity = std::atof(v.c_str());
+        else if (arg(argc, argv, i, "--charges", v)) gen.chargesDensity = std::atof(v.c_str());
+        else if (arg(argc, argv, i, "--rmt-lines", v)) gen.remittanceLines = std::atoi(v.c_str());
+        else if (arg(argc, argv, i, "--rmt-len", v)) gen.remittanceLength = std::atoi(v.c_str());
+        else if (arg(argc, argv, i, "--seed", v)) gen.seed = std::strtoull(v.c_str(), nullptr, 10);
+        else if (arg(argc, argv, i, "--min-time", v)) bench.minTime = std::atof(v.c_str());
+        else if (arg(argc, argv, i, "--filter", v)) bench.filter = v;
+        else if (arg(argc, argv, i, "--write", v)) writePath = v;
+        else {
+            std::cerr << "unknown argument: " << argv[i] << "\n";
+            return 2;
+        }
+    }
+    if (gen.statements < 1 || gen.entriesPerStatement < 1) {
+        std::cerr << "--statements and --entries must be at least 1\n";
+        return 2;
+    }
+
+    const std::string xml = camt_bench::generate_camt(gen);
+    if (!writePath.empty()) {
+        std::ofstream(writePath, std::ios::binary).write(xml.data(), (std::streamsize)xml.size());
+    }
+    bench.bytes = xml.size();
+    bench.entries = (std::size_t)gen.statements * (std::size_t)gen.entriesPerStatement;
+    std::printf("document: %.2f MB, %d statement(s) x %d entries x %d TxDtls\n\n",
+                (double)xml.size() / 1e6, gen.statements, gen.entriesPerStatement, gen.txPerEntry);
+
+    std::string err;
+    camt::Document doc;
+    {
+        camt::Parser parser;
+        if (!parser.parse_string(xml, doc, &err)) {
+            std::cerr << "parse failed: " << err << "\n";
+            return 1;
+        }
+    }
+    const unsigned flags = pugi::parse_default | pugi::parse_declaration;
+
+    bench("xml_load", [&] {
+        pugi::xml_document dom;
+        const auto t0 = Clock::now();
+        dom.load_buffer(xml.data(), xml.size(), flags);
+        return seconds_since(t0);
+    });
+
+    pugi::xml_document dom;
+    dom.load_buffer(xml.data(), xml.size(), flags);
+    bench("parse_doc", [&] {
+        camt::Document d;
+        const auto t0 = Clock::now();
+        camt::parse_document(dom, d, 0, &err);
+        return seconds_since(t0);
+    });
+
+    bench("parse_string", [&] {
+        camt::Parser parser;
+        camt::Document d;
+        const auto t0 = Clock::now();
+        parser.parse_string(xml, d, &err);
+        return seconds_since(t0);
+    });
+
+    NullBuffer nullBuf;
+    std::ostream nullOut(&nullBuf);
+    bench("export_csv", [&] {
+        const auto t0 = Clock::now();
+        camt::export_entries_csv(doc, &nullOut);
+        return seconds_since(t0);
+    });
+
+    camt::ThreadPool pool;
+    camt::ExportOptions poolOpt;
+    poolOpt.pool = &pool;
+    bench("export_csv_pool", [&] {
+        const auto t0 = Clock::now();
+        camt::export_entries_csv(doc, &nullOut, nullptr, poolOpt);
+        return seconds_since(t0);
+    });
+
+    bench("export_csv_vptr", [&] {
+        camt::ExportData rows;
+        const auto t0 = Clock::now();
+        camt::export_entries_csv(doc, &nullOut, &rows);
+        return seconds_since(t0);
+    });
+
+    camt::ExportData rows;
+    camt::export_entries_csv(doc, nullptr, &rows);
+    bench("sortExportData", [&] {
+        camt::ExportData copy = rows;
+        const auto t0 = Clock::now();
+        camt::sortExportData(copy, true, true);
+        return seconds_since(t0);
+    });
+
+    bench("accumulate_hash_row", [&] {
+        std::size_t sum = 0;
+        const auto t0 = Clock::now();
+        for (std::size_t i = 1; i < rows.size(); ++i) sum += camt::accumulate_hash_row(rows[i]).size();
+        const double t = seconds_since(t0);
+        g_sink += sum;
+        return t;
+    });
+    return 0;
+}
@@ -12,7 +12,7 @@
 
 namespace camt {
 
-const char* kGvcCsvEmbedded = R"DELIM(GVC;DC;Domain;Family;SubFamily;DomDesc;FamDesc;SubDesc;Comment
+static constexpr char kGvcCsvData[] = R"DELIM(GVC;DC;Domain;Family;SubFamily;DomDesc;FamDesc;SubDesc;Comment
 006;D;PMNT;CCRD;POSC;Payments;Customer Card Transactions;Credit Card Payment;Other debit entry advice
 058;C;PMNT;RCDT;FICT;Payments;Received Credit Transfers;Financial Institution Credit Transfer;Interbank payment (remittance credit)
 072;C;PMNT;DRFT;STLR;Payments;Drafts;Settlement Under Reserve;Redemption of bill of exchange
@@ -254,4 +254,123 @@ R"DELIM(
 999;C;XTND;NTAV;NTAV;Extended Domain;Not Available;Not Available;Unstructured assignment of remittance information field '86'
 999;D;XTND;NTAV;NTAV;Extended Domain;Not Available;Not Available;Unstructured assignment of remittance information field '86')DELIM";
 
+const char* kGvcCsvEmbedded = kGvcCsvData;
+
+// ----------------------------- Table build -------------------------------
+namespace {
+
+// one CSV line -> entry; false for the header and incomplete rows
+constexpr bool parse_line(std::string_view line, GvcEntry& out) {
+    std::string_view cols[5];
+    std::size_t n = 0;
+    while (n < 5) {
+        const std::size_t pos = line.find(';');
+        cols[n++] = detail::gvc_trim(line.substr(0, pos));
+        if (pos == std::string_view::npos) break;
+        line.remove_prefix(pos + 1);
+    }
+    if (n < 5 || cols[0] == "GVC") return false;
+    const char cr = cols[1].empty() ? '\0' : cols[1][0];
+    if (cols[0].empty() || cols[0].size() > 3 || (cr != 'C' && cr != 'D')) return false;
+    out = GvcEntry{};
+    out.domain = gvc_code(cols[2]);
+    out.family = gvc_code(cols[3]);
+    out.subFamily = gvc_code(cols[4]);
+    out.creditDebit = cr;
+    for (std::size_t i = 0; i < cols[0].size(); ++i) out.gvc[i] = cols[0][i];
+    return out.domain && out.family && out.subFamily;
+}
+
+constexpr bool same_key(const GvcEntry& a, const GvcEntry& b) {
+    return a.domain == b.domain && a.family == b.family && a.subFamily == b.subFamily
+        && a.creditDebit == b.creditDebit;
+}
+
+constexpr GvcTable build_table() {
+    constexpr std::size_t R = GvcTable::kMaxRows, B = GvcTable::kBuckets;
+    GvcTable t{};
+
+    // parse
+    std::array<GvcEntry, R> rows{};
+    std::size_t nRows = 0;
+    std::string_view rest(kGvcCsvData, sizeof(kGvcCsvData) - 1);
+    while (!rest.empty()) {
+        const std::size_t nl = rest.find('\n');
+        GvcEntry e;
+        if (parse_line(rest.substr(0, nl), e)) {
+            if (nRows == R) return t;
+            rows[nRows++] = e;
+        }
+        if (nl == std::string_view::npos) break;
+        rest.remove_prefix(nl + 1);
+    }
+
+    // group the rows by key, keeping CSV order
+    std::array<bool, R> used{};
+    std::array<std::uint16_t, R> gFirst{}, gCount{};
+    std::array<std::uint64_t, R> gHash{};
+    std::size_t pos = 0, keys = 0;
+    for (std::size_t i = 0; i < nRows; ++i) {
+        if (used[i]) continue;
+        gFirst[keys] = (std::uint16_t)pos;
+        for (std::size_t j = i; j < nRows; ++j) {
+            if (used[j] || !same_key(rows[i], rows[j])) continue;
+            used[j] = true;
+            t.entries[pos++] = rows[j];
+        }
+        gCount[keys] = (std::uint16_t)(pos - gFirst[keys]);
+        gHash[keys] = gvc_hash(rows[i].domain, rows[i].family, rows[i].subFamily, rows[i].creditDebit);
+        ++keys;
+    }
+    t.rows = nRows;
+    t.keys = keys;
+    if (keys * 4 > GvcTable::kSlots * 3) return t;  // keep the load at <= 0.75
+
+    // keys listed per bucket (counting sort)
+    std::array<std::size_t, B + 1> bStart{};
+    for (std::size_t g = 0; g < keys; ++g) ++bStart[(gHash[g] & (B - 1)) + 1];
+    for (std::size_t b = 0; b < B; ++b) bStart[b + 1] += bStart[b];
+    std::array<std::uint16_t, R> members{};
+    std::array<std::size_t, B> fill{};
+    for (std::size_t g = 0; g < keys; ++g) {
+        const std::size_t b = gHash[g] & (B - 1);
+        members[bStart[b] + fill[b]++] = (std::uint16_t)g;
+    }
+
+    // place the buckets, largest first
+    for (std::size_t size = keys; size > 0; --size) {
+        for (std::size_t b = 0; b < B; ++b) {
+            if (bStart[b + 1] - bStart[b] != size) continue;
+            bool placed = false;
+            for (std::uint32_t d = 0; d < 0x10000 && !placed; ++d) {
+                placed = true;
+                for (std::size_t i = bStart[b]; i < bStart[b + 1] && placed; ++i) {
+                    const std::size_t s = GvcTable::slot(gHash[members[i]], (std::uint16_t)d);
+                    if (t.count[s] != 0) placed = false;
+                    for (std::size_t j = bStart[b]; j < i && placed; ++j)
+                        if (GvcTable::slot(gHash[members[j]], (std::uint16_t)d) == s) placed = false;
+                }
+                if (!placed) continue;
+                t.displacement[b] = (std::uint16_t)d;
+                for (std::size_t i = bStart[b]; i < bStart[b + 1]; ++i) {
+                    const std::size_t g = members[i];
+                    const std::size_t s = GvcTable::slot(gHash[g], (std::uint16_t)d);
+                    t.first[s] = gFirst[g];
+                    t.count[s] = (std::uint8_t)gCount[g];
+                }
+            }
+            if (!placed) return t;
+        }
+    }
+    t.complete = true;
+    return t;
+}
+
+} // namespace
+
+constexpr GvcTable kGvcTable = build_table();
+
+static_assert(kGvcTable.complete, "GVC table: too many rows/keys, or no perfect hash found");
+static_assert(kGvcTable.find(gvc_code("PMNT"), gvc_code("RCDT"), gvc_code("ESCT"), 'C').size() > 0, "GVC table");
+
 } // namespace camt
\ No newline at end of file
@@ -9,7 +9,10 @@
  */
  
 #pragma once
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <tuple>
@@ -55,40 +58,141 @@ inline std::vector<std::string> split_semicolon(std::string_view line) {
     return out;
 }
 
-// ----------------------------- Minimal Map-Type ---------------------------
+// ----------------------------- Compile-time table ------------------------
+// gvc_map.cpp parses the embedded CSV during compilation into kGvcTable:
+// the rows grouped by key (Domain, Family, SubFamily as packed 4-char codes,
+// plus C/D) and a perfect hash over the distinct keys (hash and displace:
+// every bucket of keys gets a displacement that maps its keys to free
+// slots). The table is constant-initialized, so there is no startup parse,
+// and a lookup is one hash, one slot and one key compare.
+
+struct GvcEntry {
+    std::uint32_t domain = 0, family = 0, subFamily = 0;  // gvc_code()
+    char creditDebit = 0;                                 // 'C' / 'D'
+    char gvc[4] = {};                                     // "058"
+
+    constexpr std::string_view code() const { return std::string_view(gvc); }
+    constexpr int number() const {
+        int n = 0;
+        for (const char* p = gvc; *p; ++p) n = n * 10 + (*p - '0');
+        return n;
+    }
+};
+
+// the rows for one key, in CSV order (what the multimap held under that key)
+struct GvcCandidates {
+    const GvcEntry* first = nullptr;
+    std::size_t count = 0;
+
+    constexpr const GvcEntry* begin() const { return first; }
+    constexpr const GvcEntry* end() const { return first + count; }
+    constexpr std::size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr const GvcEntry& operator[](std::size_t i) const { return first[i]; }
+};
+
+namespace detail {
+constexpr bool gvc_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+constexpr std::string_view gvc_trim(std::string_view s) {
+    while (!s.empty() && gvc_space(s.front())) s.remove_prefix(1);
+    while (!s.empty() && gvc_space(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+constexpr std::uint64_t gvc_mix(std::uint64_t x) {
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+    return x ^ (x >> 33);
+}
+} // namespace detail
+
+// "pmnt " -> 0x504D4E54 (trimmed, ASCII upper case); 0 unless 4 characters
+constexpr std::uint32_t gvc_code(std::string_view s) {
+    s = detail::gvc_trim(s);
+    if (s.size() != 4) return 0;
+    std::uint32_t v = 0;
+    for (char c : s) {
+        if (c >= 'a' && c <= 'z') c = char(c - 'a' + 'A');
+        v = (v << 8) | (unsigned char)c;
+    }
+    return v;
+}
+
+constexpr std::uint64_t gvc_hash(std::uint32_t domain, std::uint32_t family, std::uint32_t subFamily, char crFlag) {
+    return detail::gvc_mix((((std::uint64_t)domain << 32) | family)
+                           ^ detail::gvc_mix(((std::uint64_t)subFamily << 8) | (unsigned char)crFlag));
+}
+
+struct GvcTable {
+    static constexpr std::size_t kMaxRows = 512;
+    static constexpr std::size_t kSlots = 512;    // power of two
+    static constexpr std::size_t kBuckets = 128;  // power of two
+
+    std::array<GvcEntry, kMaxRows> entries{};      // grouped by key
+    std::array<std::uint16_t, kSlots> first{};     // group start in entries
+    std::array<std::uint8_t, kSlots> count{};      // group size, 0 = free slot
+    std::array<std::uint16_t, kBuckets> displacement{};
+    std::size_t rows = 0;
+    std::size_t keys = 0;
+    bool complete = false;                         // every key got a slot
+
+    static constexpr std::size_t slot(std::uint64_t h, std::uint16_t d) {
+        return (std::size_t)detail::gvc_mix(h + d * 0x9E3779B97F4A7C15ull) & (kSlots - 1);
+    }
+
+    constexpr GvcCandidates find(std::uint32_t domain, std::uint32_t family, std::uint32_t subFamily, char crFlag) const {
+        if (!domain || !family || !subFamily) return {};
+        const std::uint64_t h = gvc_hash(domain, family, subFamily, crFlag);
+        const std::size_t s = slot(h, displacement[h & (kBuckets - 1)]);
+        if (count[s] == 0) return {};
+        const GvcEntry& e = entries[first[s]];
+        if (e.domain != domain || e.family != family || e.subFamily != subFamily || e.creditDebit != crFlag) return {};
+        return { &e, count[s] };
+    }
+};
+
+extern const GvcTable kGvcTable;
+
+// all GVC candidates for 3 codes + C/D (codes are trimmed and upper-cased)
+inline GvcCandidates gvc_candidates(std::string_view domain,
+                                    std::string_view family,
+                                    std::string_view variant,
+                                    char crFlag)
+{
+    return kGvcTable.find(gvc_code(domain), gvc_code(family), gvc_code(variant), crFlag);
+}
+
+// first GVC for 3 codes + C/D, "" if none
+inline std::string_view lookup_gvc(std::string_view domain,
+                                   std::string_view family,
+                                   std::string_view variant,
+                                   char crFlag)
+{
+    const GvcCandidates c = gvc_candidates(domain, family, variant, crFlag);
+    return c.empty() ? std::string_view() : c[0].code();
+}
+
+// ----------------------------- Map-Type (legacy) --------------------------
 // Key = "PMNT;RCDT;VCOM;C"   (Domain;Family;SubFamily;C|D)
 // Val = "058"                (three-digit GVC/ISO-Code)
 
 using GvcKey = std::string;
 using GvcMap = std::multimap<GvcKey, std::string>;
 
-// Builds the map from the embedded CSV.
+// Builds the map from kGvcTable.
 inline GvcMap build_gvc_map_from_embedded() {
+    auto code_str = [](std::uint32_t v) {
+        return std::string{ char(v >> 24), char(v >> 16), char(v >> 8), char(v) };
+    };
     GvcMap map;
-    std::istringstream iss(std::string{camt::kGvcCsvEmbedded});
-    std::string line;
-    int num_lines = 0;
-    // First line may be a header -> just read everything and filter
-    while (std::getline(iss, line)) {
-        auto cols = split_semicolon(line);
-        if (cols.size() < 5) 
-            continue;
-        if (!cols[0].empty() && cols[0] == "GVC") continue; // Header
-
-        const std::string iso     = trim_copy(cols[0]);            // "058"
-        const char        crFlag  = cols[1].empty() ? '\0' : cols[1][0]; // 'C'/'D'
-        const std::string domain  = upper_trim(cols[2]);           // "PMNT"
-        const std::string family  = upper_trim(cols[3]);           // "RCDT"
-        const std::string variant = upper_trim(cols[4]);           // "VCOM"
-
-        if (iso.empty() || (crFlag!='C' && crFlag!='D') ||
-            domain.empty() || family.empty() || variant.empty())
-            continue;
-
-        // Build key: "PMNT;RCDT;VCOM;C"
-        GvcKey key = domain + ";" + family + ";" + variant + ";" + std::string(1, crFlag);
-        map.insert({ key,iso }); // ISO/GVC Number
-        num_lines++;
+    for (std::size_t i = 0; i < kGvcTable.rows; ++i) {
+        const GvcEntry& e = kGvcTable.entries[i];
+        GvcKey key = code_str(e.domain) + ";" + code_str(e.family) + ";" + code_str(e.subFamily)
+                   + ";" + std::string(1, e.creditDebit);
+        map.insert({ key, std::string(e.code()) });
     }
     return map;
 }
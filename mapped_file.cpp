@@ -0,0 +1,117 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ * 
+ */
+
+#include "mapped_file.hpp"
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace camt {
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::filesystem::path& p, std::string* error)
+{
+    close();
+    auto fail = [&]() {
+        const DWORD e = GetLastError(); // must read immediately
+        if (error) *error = e ? std::system_category().message(static_cast<int>(e)) : std::string("unknown error");
+        close();
+        return false;
+    };
+
+    HANDLE f = CreateFileW(p.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return fail();
+    file_ = f;
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz)) return fail();
+    if (static_cast<unsigned long long>(sz.QuadPart) > static_cast<unsigned long long>(SIZE_MAX)) {
+        SetLastError(ERROR_FILE_TOO_LARGE);
+        return fail();
+    }
+    size_ = static_cast<std::size_t>(sz.QuadPart);
+    open_ = true;
+    if (size_ == 0) return true; // nothing to map
+
+    HANDLE m = CreateFileMappingW(f, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!m) return fail();
+    mapping_ = m;
+
+    void* v = MapViewOfFile(m, FILE_MAP_COPY, 0, 0, 0);
+    if (!v) return fail();
+    data_ = static_cast<char*>(v);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_) CloseHandle(static_cast<HANDLE>(file_));
+    data_ = nullptr; mapping_ = nullptr; file_ = nullptr;
+    size_ = 0; open_ = false;
+}
+
+#else // POSIX
+
+bool MappedFile::open(const std::filesystem::path& p, std::string* error)
+{
+    close();
+    auto fail = [&](int e) {
+        if (error) *error = e ? std::system_category().message(e) : std::string("unknown error");
+        return false;
+    };
+
+    errno = 0;
+    const int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail(errno);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) { const int e = errno; ::close(fd); return fail(e); }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_ > 0) {
+        // PROT_WRITE + MAP_PRIVATE: in-place parsing writes into private pages only
+        void* v = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (v == MAP_FAILED) { const int e = errno; ::close(fd); size_ = 0; return fail(e); }
+        data_ = static_cast<char*>(v);
+#ifdef MADV_SEQUENTIAL
+        ::madvise(v, size_, MADV_SEQUENTIAL);
+#endif
+    }
+    ::close(fd); // the mapping keeps its own reference
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_) ::munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+#endif
+
+} // namespace camt
@@ -0,0 +1,58 @@
+/**
+ * camt parser - version 1.00
+ * --------------------------------------------------------
+ * Report bugs and download new versions at https://github.com/psynetic-software/camt-parser
+ *
+ * SPDX-FileCopyrightText: 2025 psynectic
+ * SPDX-License-Identifier: MIT
+ * 
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <filesystem>
+
+namespace camt {
+
+// Read-only file mapped copy-on-write (mmap MAP_PRIVATE / MapViewOfFile
+// FILE_MAP_COPY): the view may be modified in place, e.g. by
+// pugi::xml_document::load_buffer_inplace, without touching the file.
+// Platform code lives in mapped_file.cpp to keep <windows.h> out of headers.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& o) noexcept { swap(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept { if (this != &o) { close(); swap(o); } return *this; }
+
+    // on failure *error receives the system message (errno / GetLastError)
+    bool open(const std::filesystem::path& p, std::string* error = nullptr);
+    void close();
+
+    bool is_open() const { return open_; }
+    char* data() const { return data_; }   // nullptr for empty files
+    std::size_t size() const { return size_; }
+
+private:
+    void swap(MappedFile& o) noexcept {
+        std::swap(data_, o.data_); std::swap(size_, o.size_); std::swap(open_, o.open_);
+#ifdef _WIN32
+        std::swap(file_, o.file_); std::swap(mapping_, o.mapping_);
+#endif
+    }
+
+    char*       data_ = nullptr;
+    std::size_t size_ = 0;
+    bool        open_ = false;
+#ifdef _WIN32
+    void* file_    = nullptr; // HANDLE
+    void* mapping_ = nullptr; // HANDLE
+#endif
+};
+
+} // namespace camt